@@ -40,7 +40,19 @@ namespace lsp
             static constexpr float DETECT_TIME_RANGE_MAX    =   100.0f;
             static constexpr float DETECT_TIME_RANGE_MIN    =   - 100.0f;
 
+            static constexpr float LAG_MIN_MIN              =   DETECT_TIME_RANGE_MIN;
+            static constexpr float LAG_MIN_MAX              =   DETECT_TIME_RANGE_MAX;
+            static constexpr float LAG_MIN_DFL              =   DETECT_TIME_RANGE_MIN;
+            static constexpr float LAG_MIN_STEP             =   0.1f;
+
+            static constexpr float LAG_MAX_MIN              =   DETECT_TIME_RANGE_MIN;
+            static constexpr float LAG_MAX_MAX              =   DETECT_TIME_RANGE_MAX;
+            static constexpr float LAG_MAX_DFL              =   DETECT_TIME_RANGE_MAX;
+            static constexpr float LAG_MAX_STEP             =   0.1f;
+
             static constexpr size_t MESH_POINTS             =   256;
+            static constexpr size_t ACCUMULATORS            =   2;          // Number of additional accumulators of the correlation function
+            static constexpr size_t PEAKS_MAX               =   4;          // Number of tracked local maximums/minimums, including the best/worst one
 
             static constexpr float REACT_TIME_MIN           =   0.000;
             static constexpr float REACT_TIME_MAX           =  10.000;
@@ -52,6 +64,46 @@ namespace lsp
             static constexpr float SELECTOR_DFL             =   0.0f;
             static constexpr float SELECTOR_STEP            =   0.1f;
 
+            static constexpr float HOP_TIME_MIN             =   1.0f;
+            static constexpr float HOP_TIME_MAX             =   200.0f;
+            static constexpr float HOP_TIME_DFL             =   20.0f;
+            static constexpr float HOP_TIME_STEP            =   0.0025f;
+
+            static constexpr size_t MIDI_CC_DELAY_MSB       =   16;         // MIDI controller for the best delay, most significant bits
+            static constexpr size_t MIDI_CC_DELAY_LSB       =   48;         // MIDI controller for the best delay, least significant bits
+
+            static constexpr size_t PREWHITEN_ORDER         =   8;          // Order of the linear prediction of the pre-whitening filter
+            static constexpr size_t PREWHITEN_BUFFER_SIZE   =   0x400;      // Size of the pre-whitening buffer
+            static constexpr float PREWHITEN_TIME           =   200.0f;     // Averaging time of the signal spectrum for pre-whitening [ms]
+
+            static constexpr float ALIGN_FADE_TIME          =   20.0f;      // Crossfade time on alignment change [ms]
+            static constexpr float ALIGN_HOLD_TIME          =   250.0f;     // Time the new delay should remain stable [ms]
+            static constexpr size_t ALIGN_BUFFER_SIZE       =   0x400;      // Size of temporary buffer for alignment
+            static constexpr float ALIGN_CONFIDENCE         =   0.1f;       // Minimum confidence of the detected offset to change the alignment
+
+            static constexpr size_t SPECTRUM_RANK_MIN       =   10;         // Minimum FFT rank for spectral analysis
+            static constexpr size_t SPECTRUM_POINTS         =   256;        // Number of points in spectral meshes
+            static constexpr float SPECTRUM_FREQ_MIN        =   20.0f;      // Minimum displayed frequency
+            static constexpr float SPECTRUM_FREQ_MAX        =   20000.0f;   // Maximum displayed frequency
+
+            static constexpr float EXCITATION_LEVEL_MIN     =   0.001f;     // -60 dB
+            static constexpr float EXCITATION_LEVEL_MAX     =   1.0f;       // 0 dB
+            static constexpr float EXCITATION_LEVEL_DFL     =   0.125f;     // -18 dB
+            static constexpr float EXCITATION_LEVEL_STEP    =   0.01f;
+            static constexpr size_t MLS_ORDER_MIN           =   10;         // Minimum order of maximum length sequence
+            static constexpr size_t MLS_ORDER_MAX           =   18;         // Maximum order of maximum length sequence
+
+            static constexpr float WARM_STATE_INTERVAL      =   5.0f;       // Interval between snapshots of the correlation state [s]
+
+            static constexpr size_t MT_CHUNK_SIZE           =   0x400;      // Number of lags processed by one job chunk in multithreaded mode
+            static constexpr size_t CACHE_TILE_SIZE         =   0x200;      // Number of lags updated for all samples of the gap at once
+
+            static constexpr float TELEMETRY_INTERVAL_MIN   =   0.01f;
+            static constexpr float TELEMETRY_INTERVAL_MAX   =   60.0f;
+            static constexpr float TELEMETRY_INTERVAL_DFL   =   1.0f;
+            static constexpr float TELEMETRY_INTERVAL_STEP  =   0.0025f;
+            static constexpr size_t TELEMETRY_RECORDS       =   0x400;      // Capacity of the telemetry ring buffer
+
             static constexpr float SAMPLES_MIN              =   - 50.0f /* DETECT_TIME_MAX [ms] */ * 0.001 /* [s/ms] */ * MAX_SAMPLE_RATE /* [ samples / s ] */;
             static constexpr float SAMPLES_MAX              =   + 50.0f /* DETECT_TIME_MAX [ms] */ * 0.001 /* [s/ms] */ * MAX_SAMPLE_RATE /* [ samples / s ] */;
             static constexpr float DISTANCE_MIN             =   - 50.0f /* DETECT_TIME_MAX [ms] */ * 0.001 /* [s/ms] */ * MAX_SOUND_SPEED /* [ m / s] */ * 100 /* c / m */;
@@ -60,6 +112,10 @@ namespace lsp
             static constexpr float TIME_MAX                 =   + 50.0f /* DETECT_TIME_MAX [ms] */;
             static constexpr float VALUE_MIN                =   -1.0f;
             static constexpr float VALUE_MAX                =   +1.0f;
+            static constexpr float CONFIDENCE_MIN           =   0.0f;
+            static constexpr float CONFIDENCE_MAX           =   1.0f;
+            static constexpr float EXTREMUMS_MIN            =   0.0f;
+            static constexpr float EXTREMUMS_MAX            =   PEAKS_MAX - 1;
         };
 
         extern const plugin_t phase_detector;
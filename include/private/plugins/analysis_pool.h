@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-phase-detector
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-plugins-phase-detector is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-phase-detector is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-phase-detector. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PLUGINS_ANALYSIS_POOL_H_
+#define PRIVATE_PLUGINS_ANALYSIS_POOL_H_
+
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/ipc/Mutex.h>
+#include <lsp-plug.in/ipc/Thread.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Process-wide pool of analysis threads shared between all plugin instances.
+         * Each instance connects to the pool and obtains a slot. The job submitted to
+         * the slot is split into chunks which are processed both by the submitting thread
+         * and the worker threads, so the submitting thread never waits for the job to be
+         * scheduled: the result is always ready when the execute() call returns.
+         * Workers compute chunks into the private storage of the chunk, and the submitting
+         * thread commits the results. If the worker does not finish the chunk within
+         * the deadline, the submitting thread takes the chunk back and processes it itself,
+         * the late result of the worker is discarded. So the time of the execute() call
+         * is bounded even if the worker thread has been preempted.
+         * Workers scan slots in round-robin order, so each connected instance gets
+         * the fair share of worker threads. Idle workers sleep until the next job
+         * is published.
+         */
+        class analysis_pool
+        {
+            public:
+                static constexpr size_t SLOTS_MAX           = 256;      // Maximum number of connected instances
+                static constexpr size_t THREADS_MAX         = 8;        // Maximum number of worker threads
+                static constexpr size_t IDLE_TIMEOUT        = 100;      // Maximum time the idle worker sleeps [ms]
+                static constexpr size_t CHUNKS_MAX          = 64;       // Maximum number of chunks in the job
+                static constexpr size_t DEADLINE_CHUNKS     = 2;        // Deadline for workers, in the average time of one chunk
+
+            public:
+                /**
+                 * Job that can be split into independent chunks
+                 */
+                class IJob
+                {
+                    public:
+                        virtual ~IJob();
+
+                    public:
+                        /**
+                         * Process the chunk of the job in place, called by the submitting thread
+                         * @param index index of the chunk
+                         */
+                        virtual void        run_chunk(size_t index) = 0;
+
+                        /**
+                         * Prepare the private storage of the chunk before passing it to the worker,
+                         * called by the submitting thread
+                         * @param index index of the chunk
+                         */
+                        virtual void        prepare_chunk(size_t index) = 0;
+
+                        /**
+                         * Process the chunk of the job into the private storage of the chunk,
+                         * called by the worker thread
+                         * @param index index of the chunk
+                         */
+                        virtual void        compute_chunk(size_t index) = 0;
+
+                        /**
+                         * Apply the result stored in the private storage of the chunk,
+                         * called by the submitting thread
+                         * @param index index of the chunk
+                         */
+                        virtual void        commit_chunk(size_t index) = 0;
+                };
+
+            private:
+                // States of the chunk
+                static constexpr uatomic_t  CS_IDLE     = 0;        // Chunk is not published
+                static constexpr uatomic_t  CS_READY    = 1;        // Chunk is published and can be taken by worker
+                static constexpr uatomic_t  CS_BUSY     = 2;        // Chunk is processed by worker
+                static constexpr uatomic_t  CS_DONE     = 3;        // Chunk is processed by worker and ready to commit
+                static constexpr uatomic_t  CS_LOST     = 4;        // Chunk has been taken back while the worker still processes it
+
+                typedef struct slot_t
+                {
+                    IJob               *pJob;               // Currently executed job
+                    size_t              nChunks;            // Number of chunks in the job
+                    uatomic_t           nReady;             // Number of chunks that can be taken by workers
+                    uatomic_t           nUsers;             // Number of workers accessing the slot
+                    uatomic_t           vState[CHUNKS_MAX]; // State of each chunk
+                    wsize_t             nChunkTime;         // Average time of processing one chunk by submitting thread [ns]
+                    bool                bUsed;              // Slot is used by some instance
+                } slot_t;
+
+                class Worker: public ipc::Thread
+                {
+                    private:
+                        analysis_pool      *pPool;
+                        size_t              nFirst;
+
+                    public:
+                        explicit Worker(analysis_pool *pool, size_t first);
+                        virtual ~Worker() override;
+
+                    public:
+                        virtual status_t    run() override;
+                };
+
+                struct wakeup_t;
+
+            private:
+                slot_t              vSlots[SLOTS_MAX];
+                Worker             *vWorkers[THREADS_MAX];
+                size_t              nWorkers;
+                size_t              nSlots;             // Number of slots to scan by workers
+                uatomic_t           nGeneration;        // Incremented each time the new job is published
+                wakeup_t           *pWakeup;            // Wake-up event for idle workers
+
+                static ipc::Mutex       sLock;
+                static analysis_pool   *pInstance;
+                static size_t           nReferences;
+
+            private:
+                analysis_pool & operator = (const analysis_pool &);
+                analysis_pool(const analysis_pool &);
+
+            protected:
+                explicit analysis_pool();
+                ~analysis_pool();
+
+            protected:
+                bool                start();
+                void                stop();
+                bool                process_slot(size_t index);
+                void                wait_job(uatomic_t generation);
+                void                wake_workers();
+
+            public:
+                /**
+                 * Connect to the pool, the pool will be started on the first connection
+                 * @return connection identifier or negative value if pool is not available
+                 */
+                static ssize_t      connect();
+
+                /**
+                 * Disconnect from the pool, the pool will be stopped on the last disconnection
+                 * @param id connection identifier
+                 */
+                static void         disconnect(ssize_t id);
+
+                /**
+                 * Execute the job and wait for completion
+                 * @param id connection identifier
+                 * @param job job to execute
+                 * @param chunks number of chunks in the job
+                 */
+                static void         execute(ssize_t id, IJob *job, size_t chunks);
+
+                /**
+                 * Wait until workers leave the slot, including the ones that still process
+                 * the chunks taken back by the submitting thread. Should be called before
+                 * releasing the data accessed by the job. Should not be called by the audio thread.
+                 * @param id connection identifier
+                 */
+                static void         wait(ssize_t id);
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_PLUGINS_ANALYSIS_POOL_H_ */
@@ -26,8 +26,12 @@
 #include <lsp-plug.in/dsp-units/ctl/Bypass.h>
 #include <lsp-plug.in/plug-fw/plug.h>
 #include <lsp-plug.in/plug-fw/core/IDBuffer.h>
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/io/NativeFile.h>
+#include <lsp-plug.in/ipc/ITask.h>
 
 #include <private/meta/phase_detector.h>
+#include <private/plugins/analysis_pool.h>
 
 namespace lsp
 {
@@ -41,6 +45,65 @@ namespace lsp
             private:
                 phase_detector & operator = (const phase_detector &);
 
+            protected:
+                class TelemetryWriter: public ipc::ITask
+                {
+                    private:
+                        phase_detector     *pCore;
+
+                    public:
+                        explicit TelemetryWriter(phase_detector *core);
+                        virtual ~TelemetryWriter() override;
+
+                    public:
+                        virtual status_t    run() override;
+                };
+
+                class WarmStateWriter: public ipc::ITask
+                {
+                    private:
+                        phase_detector     *pCore;
+                        const uint8_t      *pData;              // Snapshot being written
+                        size_t              nSize;              // Size of the snapshot
+
+                    public:
+                        explicit WarmStateWriter(phase_detector *core);
+                        virtual ~WarmStateWriter() override;
+
+                    public:
+                        void                bind(const uint8_t *data, size_t size);
+                        virtual status_t    run() override;
+                };
+
+                class PoolConnector: public ipc::ITask
+                {
+                    private:
+                        phase_detector     *pCore;
+
+                    public:
+                        explicit PoolConnector(phase_detector *core);
+                        virtual ~PoolConnector() override;
+
+                    public:
+                        virtual status_t    run() override;
+                };
+
+                class CorrelationJob: public analysis_pool::IJob
+                {
+                    private:
+                        phase_detector     *pCore;
+
+                    public:
+                        explicit CorrelationJob(phase_detector *core);
+                        virtual ~CorrelationJob() override;
+
+                    public:
+                        virtual void        run_chunk(size_t index) override;
+                        virtual void        prepare_chunk(size_t index) override;
+                        virtual void        compute_chunk(size_t index) override;
+                        virtual void        commit_chunk(size_t index) override;
+                };
+
             protected:
                 typedef struct buffer_t
                 {
@@ -56,6 +119,125 @@ namespace lsp
                     plug::IPort        *pValue;
                 } meters_t;
 
+                typedef struct channel_t
+                {
+                    dspu::Delay         sLine[2];           // Delay lines: active one and the one to fade in
+                    float               fGain[2];           // Gain applied to each delay line
+                    float              *vBuffer;            // Temporary buffer for the fading delay line
+                } channel_t;
+
+                typedef struct telemetry_t
+                {
+                    wssize_t            nSeconds;           // Wall clock time: seconds
+                    ssize_t             nNanos;             // Wall clock time: nanoseconds
+                    wsize_t             nPosition;          // Number of samples processed since start
+                    ssize_t             nBest;              // Best offset
+                    ssize_t             nSelected;          // Selected offset
+                    ssize_t             nWorst;             // Worst offset
+                    float               fValue;             // Correlation value at the best offset
+                    float               fConfidence;        // Confidence of the best offset
+                } telemetry_t;
+
+                typedef struct extremum_t
+                {
+                    size_t              nIndex;             // Index in the correlation function
+                    float               fValue;             // Absolute value of the correlation function
+                } extremum_t;
+
+                typedef struct extremum_meters_t
+                {
+                    plug::IPort        *pPeakTime;
+                    plug::IPort        *pPeakValue;
+                    plug::IPort        *pDipTime;
+                    plug::IPort        *pDipValue;
+                } extremum_meters_t;
+
+                typedef struct spectrum_t
+                {
+                    float              *vFrame[2];          // Input frames of A and B
+                    float              *vFft[2];            // FFT of A and B, packed complex
+                    float              *vTemp;              // Temporary buffer for windowed frame
+                    float              *vWindow;            // Analysis window
+                    float              *vCross;             // Averaged cross-spectrum A * conj(B), packed complex
+                    float              *vPower[2];          // Averaged power spectrum of A and B
+                    size_t              nRank;              // FFT rank
+                    size_t              nSize;              // FFT size
+                    size_t              nFill;              // Number of samples in frame buffers
+                    float               fTau;               // Averaging factor applied per each frame
+                } spectrum_t;
+
+                typedef struct accumulator_t
+                {
+                    float              *vData;              // Accumulated correlation function
+                    float               fReactivity;        // Reactivity
+                    float               fTau;               // Averaging factor applied per each sample
+                    float               fPeriodTau;         // Averaging factor applied per each period of active measurement
+                    float               fNorm;              // Normalizing factor
+                    ssize_t             nBest;              // Best offset
+                    ssize_t             nWorst;             // Worst offset
+                    float               fBestValue;         // Normalized correlation at best position
+                    float               fWorstValue;        // Normalized correlation at worst position
+                    bool                bEnabled;           // Accumulator is enabled
+
+                    plug::IPort        *pEnabled;           // Enable switch
+                    plug::IPort        *pReactivity;        // Reactivity
+                    plug::IPort        *pBestTime;          // Best time meter
+                    plug::IPort        *pBestValue;         // Best value meter
+                    plug::IPort        *pWorstTime;         // Worst time meter
+                    plug::IPort        *pWorstValue;        // Worst value meter
+                    plug::IPort        *pFunction;          // Output function
+                } accumulator_t;
+
+                typedef struct corr_chunk_t
+                {
+                    size_t              nFirst;             // First lag of the chunk
+                    size_t              nCount;             // Number of lags in the chunk
+                    size_t              nGapOffset;         // First sample of the gap to process
+                    size_t              nGapSize;           // End of the gap to process
+                    size_t              nVectorSize;        // Size of the correlation window
+                    float               fTau;               // Averaging factor of the accumulated function
+                    float               vTau[meta::phase_detector_metadata::ACCUMULATORS];      // Averaging factors of accumulators
+                    bool                vEnabled[meta::phase_detector_metadata::ACCUMULATORS];  // Enabled accumulators
+                    float              *vFunction;          // Private copy of the function
+                    float              *vAccumulated;       // Private copy of the accumulated function
+                    float              *vAccumulators[meta::phase_detector_metadata::ACCUMULATORS]; // Private copies of accumulators
+                } corr_chunk_t;
+
+                typedef struct prewhiten_t
+                {
+                    float              *vBuffer[2];         // History and input data of each channel
+                    float              *vOut[2];            // Whitened data of each channel
+                    float               vCorr[meta::phase_detector_metadata::PREWHITEN_ORDER + 1];  // Averaged autocorrelation of inputs
+                    float               vCoeffs[meta::phase_detector_metadata::PREWHITEN_ORDER + 1];// Coefficients of the inverse filter
+                    float               fLogDecay;          // Logarithm of the averaging factor applied per each sample
+                } prewhiten_t;
+
+                typedef struct mls_t
+                {
+                    float              *vSignal;            // Maximum length sequence, values of +1 and -1
+                    uint32_t           *vTagS;              // Permutation of the captured signal before the Hadamard transform
+                    uint32_t           *vTagL;              // Permutation of the correlation function after the Hadamard transform
+                    float              *vCapture;           // Captured response for the current period
+                    float              *vTransform;         // Buffer for the Hadamard transform
+                    float              *vExcitation;        // Excitation signal for the current part of the block
+                    size_t              nOrder;             // Order of the sequence
+                    size_t              nLength;            // Length of the sequence
+                    size_t              nPosition;          // Current position in the sequence
+                    size_t              nPeriods;           // Number of complete periods since start
+                    float               fTau;               // Averaging factor applied per each period
+                    float               fLevel;             // Excitation level
+                } mls_t;
+
+                typedef struct warm_header_t
+                {
+                    uint32_t            nMagic;             // Magic number
+                    uint32_t            nSampleRate;        // Sample rate
+                    uint32_t            nVectorSize;        // Size of the analysis window
+                    uint32_t            nFuncFirst;         // First computed index of the correlation function
+                    uint32_t            nFuncCount;         // Number of computed elements of the correlation function
+                    uint32_t            nPoints;            // Number of stored points
+                } warm_header_t;
+
                 enum meter_kind_t
                 {
                     MK_BEST,
@@ -76,6 +258,10 @@ namespace lsp
                 size_t              nMaxVectorSize;
                 size_t              nVectorSize;
                 size_t              nFuncSize;
+                size_t              nFuncFirst;         // First computed index of the correlation function
+                size_t              nFuncCount;         // Number of computed elements of the correlation function
+                float               fLagMin;            // Minimum lag, percents of the maximum time
+                float               fLagMax;            // Maximum lag, percents of the maximum time
 
                 size_t              nGapSize;
                 size_t              nMaxGapSize;
@@ -86,32 +272,167 @@ namespace lsp
                 ssize_t             nWorst;
 
                 buffer_t            vA, vB;
+                channel_t           vChannels[2];
+
+                float               fBestValue;         // Normalized correlation at best position
+                float               fSelectedValue;     // Normalized correlation at selected position
+                float               fWorstValue;        // Normalized correlation at worst position
+                float               fConfidence;        // Confidence of the best position: peak-to-sidelobe level
+                extremum_t          vPeaks[meta::phase_detector_metadata::PEAKS_MAX];   // Highest local maximums
+                extremum_t          vDips[meta::phase_detector_metadata::PEAKS_MAX];    // Lowest local minimums
+                size_t              nPeaks;             // Number of local maximums except the best one
+                size_t              nDips;              // Number of local minimums except the worst one
+                accumulator_t       vAccumulators[meta::phase_detector_metadata::ACCUMULATORS];     // Additional accumulators
+
+                ssize_t             nAlign;             // Currently applied alignment, positive value delays B
+                bool                bAlignInv;          // Currently applied polarity inversion of B
+                ssize_t             nAlignReq;          // Requested alignment
+                bool                bAlignReqInv;       // Requested polarity inversion of B
+                size_t              nAlignHold;         // Number of samples the requested alignment remains stable
+                size_t              nAlignHoldMax;      // Number of samples the requested alignment should remain stable
+                size_t              nActiveLine;        // Index of the active delay line
+                size_t              nFadePos;           // Current position of the crossfade
+                size_t              nFadeLen;           // Length of the crossfade
+
+                spectrum_t          sSpectrum;          // Spectral analysis
+                bool                bSpectral;          // Spectral analysis is enabled
+
+                TelemetryWriter     sTlmWriter;         // Telemetry writer task
+                io::NativeFile      sTlmFile;           // Telemetry output file
+                telemetry_t         vTlmRecords[meta::phase_detector_metadata::TELEMETRY_RECORDS]; // Telemetry ring buffer
+                uatomic_t           nTlmHead;           // Position of the next record to write, modified by the audio thread
+                uatomic_t           nTlmTail;           // Position of the next record to read, modified by the writer task
+                wsize_t             nTlmPosition;       // Number of samples processed
+                size_t              nTlmCounter;        // Number of samples since the last record
+                size_t              nTlmInterval;       // Interval between records in samples
+                size_t              nTlmDropped;        // Number of records dropped because of ring buffer overflow
+                bool                bTelemetry;         // Telemetry is enabled
+                bool                bTlmReopen;         // Telemetry file should be reopened
+                bool                bTlmOpened;         // Telemetry file is opened
+                char                sTlmPath[PATH_MAX]; // Path to the telemetry file
+
+                prewhiten_t         sPrewhiten;         // Pre-whitening of inputs
+                bool                bPrewhiten;         // Pre-whitening is enabled
+
+                CorrelationJob      sCorrJob;           // Correlation update job
+                PoolConnector       sPoolConnector;     // Background connection to the analysis pool
+                ssize_t             nPoolId;            // Identifier of connection to the analysis pool
+                ssize_t             nPoolPending;       // Identifier of connection obtained by the background task
+                size_t              nJobChunks;         // Number of chunks in the correlation update job
+                corr_chunk_t       *vChunks;            // Parameters and private storage of job chunks
+                size_t              nChunks;            // Number of allocated job chunks
+                float              *vChunkData;         // Private storage of job chunks
+                bool                bMultithread;       // Multithreaded analysis is enabled
+
+                mls_t               sMls;               // Active measurement
+                bool                bActive;            // Active measurement is enabled
+                size_t              nActiveFade;        // Crossfade position between the output signal (0) and the excitation (nFadeLen)
+
+                WarmStateWriter     sWarmWriter;        // Warm state writer task
+                uint8_t            *vWarmState;         // Snapshot of the correlation state: header and accumulated function, little-endian
+                size_t              nWarmSize;          // Size of the snapshot in bytes
+                uint8_t            *vWarmRetired;       // Dropped snapshot still being written by the warm state writer
+                size_t              nWarmCounter;       // Number of samples since the last snapshot
+                size_t              nWarmInterval;      // Interval between snapshots in samples
+                bool                bWarmStart;         // Warm start is enabled
+                bool                bWarmLoad;          // The saved state should be restored
+
+                float               fHopTime;           // Analysis hop time
+                size_t              nHopSize;           // Analysis hop size in samples
+                size_t              nHopCounter;        // Number of samples analyzed since the last hop
+                ssize_t             nEventBest;         // Best offset reported by the last event
+                bool                bEventValid;        // The last reported best offset is valid
 
                 float               fTau;
                 float               fSelector;
                 bool                bBypass;
+                bool                bAlign;
+                bool                bPolarity;
 
                 plug::IPort        *vIn[2];             // Inputs
                 plug::IPort        *vOut[2];            // Outputs
+                plug::IPort        *pMidiOut;           // MIDI output
                 plug::IPort        *pBypass;            // Bypass switch
                 plug::IPort        *pReset;             // Reset button
                 plug::IPort        *pSelector;          // Selector knob
+                plug::IPort        *pLagMin;            // Minimum lag
+                plug::IPort        *pLagMax;            // Maximum lag
                 plug::IPort        *pTime;              // Time
                 plug::IPort        *pReactivity;        // Reactivity
+                plug::IPort        *pHop;               // Analysis hop
+                plug::IPort        *pAlign;             // Automatic alignment switch
+                plug::IPort        *pPolarity;          // Polarity correction switch
+                plug::IPort        *pSpectral;          // Spectral analysis switch
+                plug::IPort        *pPrewhiten;         // Pre-whitening switch
+                plug::IPort        *pMultithread;       // Multithreaded analysis switch
+                plug::IPort        *pActive;            // Active measurement switch
+                plug::IPort        *pActiveLevel;       // Excitation level
+                plug::IPort        *pWarmStart;         // Warm start switch
+                plug::IPort        *pTelemetry;         // Telemetry switch
+                plug::IPort        *pTlmInterval;       // Telemetry interval
+                plug::IPort        *pTlmFile;           // Telemetry file
                 meters_t            vMeters[MK_COUNT];  // Output meters
+                plug::IPort        *pAlignTime;         // Applied alignment time
+                plug::IPort        *pConfidence;        // Confidence meter
+                plug::IPort        *pNumPeaks;          // Number of secondary peaks
+                plug::IPort        *pNumDips;           // Number of secondary dips
+                extremum_meters_t   vExtMeters[meta::phase_detector_metadata::PEAKS_MAX - 1];  // Secondary peak meters
                 plug::IPort        *pFunction;          // Output function
+                plug::IPort        *pCoherence;         // Output coherence
+                plug::IPort        *pGroupDelay;        // Output group delay
 
                 core::IDBuffer     *pIDisplay;          // Inline display buffer
 
             protected:
                 size_t              fill_gap(const float *a, const float *b, size_t count);
                 void                clear_buffers();
+                void                clear_spectrum();
                 bool                set_time_interval(float interval, bool force);
+                bool                set_lag_range(float min, float max, bool force);
                 void                set_reactive_interval(float interval);
+                void                set_accumulator_reactivity(accumulator_t *acc, float interval);
+                void                analyze(const float *in_a, const float *in_b, size_t samples);
+                void                correlate(const float *a, const float *b, size_t samples);
+                void                prewhiten(const float *a, const float *b, size_t samples);
+                void                update_function(size_t first, size_t count);
+                void                update_range(const corr_chunk_t *c, float *func, float *accum, float * const *accs);
+                void                update_tile(const corr_chunk_t *c, float *func, float *accum, float * const *accs, size_t index, size_t count);
+                void                init_chunk(corr_chunk_t *c, size_t first, size_t count);
+                void                compute_chunk(corr_chunk_t *c);
+                void                commit_chunk(const corr_chunk_t *c);
+                void                update_results();
+                void                emit_delay_event(plug::midi_t *midi, size_t timestamp);
+                void                find_extremums();
+                void                generate_mls();
+                void                process_active(float *dst, const float *in_b, size_t samples, bool measure);
+                void                fade_excitation(float *out_a, float *out_b, const float *src, size_t samples, bool active);
+                void                analyze_mls();
+                void                process_spectrum(const float *a, const float *b, size_t samples);
+                void                analyze_frame();
+                void                output_spectrum();
+                void                output_meters(plug::mesh_t *mesh);
+                void                output_function(plug::mesh_t *mesh, const float *f, float norm);
+                void                output_accumulators();
+                void                update_alignment(size_t samples);
+                void                feed_alignment(const float *src, size_t channel, size_t samples);
+                void                process_alignment(float *dst, const float *src, size_t channel, size_t samples);
+                void                update_telemetry(size_t samples);
+                status_t            write_telemetry();
+                void                update_warm_state(size_t samples);
+                void                restore_warm_state();
+                status_t            write_warm_state(const uint8_t *data, size_t size);
+                void                release_warm_state();
+                void                request_pool();
+                status_t            connect_pool();
                 void                do_destroy();
 
             protected:
                 static void         dump_buffer(dspu::IStateDumper *v, const buffer_t *buf, const char *label);
+                static void         dump_extremums(dspu::IStateDumper *v, const extremum_t *list, const char *label);
+                static void         insert_extremum(extremum_t *list, size_t *count, size_t index, float value);
+                static void         hadamard_transform(float *v, size_t count);
+                static bool         wait_task(ipc::ITask *task, size_t timeout);
+                static void         levinson_durbin(float *a, const float *r, size_t order);
 
             public:
                 explicit            phase_detector(const meta::plugin_t *meta);
@@ -124,6 +445,7 @@ namespace lsp
                 virtual void        update_sample_rate(long sr) override;
                 virtual void        update_settings() override;
                 virtual void        process(size_t samples) override;
+                virtual void        state_loaded() override;
                 virtual bool        inline_display(plug::ICanvas *cv, size_t width, size_t height) override;
                 virtual void        dump(dspu::IStateDumper *v) const override;
         };
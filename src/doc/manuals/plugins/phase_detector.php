@@ -6,7 +6,8 @@ set at the different positions and distances from the sound source.</p>
 <p><u>Be aware</u>: because there are many correlation functions for different phases calculated at one time,
 the entire analyzing process can take a lot of CPU resources. You can also reduce CPU utilization
 by lowering the maximum analysis time.<p>
-<p>The plugin bypasses input signal without any modifications, so it can be placed everywhere it's needed.</p>
+<p>The plugin bypasses input signal without any modifications, so it can be placed everywhere it's needed.
+Optionally, the plugin can automatically delay the leading channel by the detected offset to align both channels.</p>
 <p><b>Controls:</b></p>
 <ul>
 	<li>
@@ -23,14 +24,114 @@ by lowering the maximum analysis time.<p>
 		case when each individual curve of the correlation function is passed thru the lowpass filter.
 		The lesser reactivity value causes less stable correlation graph but gives more tolerance and vice verse.
 	</li>
+	<li>
+		<b>Hop</b> - the interval between two subsequent evaluations of the correlation function. The best, selected and worst offsets are
+		updated at the end of each hop independently of the block size used by the host, so the results do not depend on the block size.
+		Each change of the best offset is reported to the MIDI output as a pair of control change messages for controllers 16 and 48 on the first
+		channel, which form the 14-bit value of the best time: the range from -50 ms to +50 ms is mapped to values from 0 to 16383.
+		The events are timestamped with the position of the last sample of the hop, so they are sample-accurate even for large blocks.
+	</li>
 	<li>
 		<b>Sel time</b> - the custom time selected for metering. 
 		Actually is the amount in percent (%) of the maximum analysis time.
 		The metering values for this parameter are colored with yellow in monitoring section.
 	</li>
+	<li>
+		<b>Min lag</b>, <b>Max lag</b> - the range of offsets to analyze, in percent (%) of the maximum analysis time.
+		The correlation function is computed only for offsets within the range, so narrowing the range reduces CPU utilization
+		proportionally. For example, if it is known that the channel <b>B</b> always comes with delay relatively to the channel
+		<b>A</b>, setting <b>Max lag</b> to 0% halves the amount of computations. The <b>Sel time</b> is limited to the range.
+		The state of analyser will be automatically reset on change of these controls.
+	</li>
 	<li><b>Reset</b> - this control allows to immediately reset the state of analyser.</li>
+	<li>
+		<b>Auto align</b> - enables automatic alignment of the output signal. The leading channel is delayed by the offset displayed in the <b>Best</b> row.
+		The new delay is applied only when the detected offset remains stable for some time, the change is performed with a short crossfade.
+		While nothing reliable is detected, for example on silence or just after reset, or the <b>Confidence</b> is too low, the current delay is kept.
+		Because only the leading channel is delayed, the plugin does not introduce any additional latency.
+	</li>
+	<li>
+		<b>Polarity fix</b> - when <b>Auto align</b> is enabled, allows to use the <b>Worst</b> offset for the alignment and invert the polarity of the <b>B</b> channel
+		if the absolute value of the correlation function in the <b>Worst</b> point is greater than in the <b>Best</b> point.
+	</li>
+	<li>
+		<b>Pre-whiten</b> - enables the adaptive pre-whitening of inputs before the computation of the correlation function. Both inputs are
+		passed through the same linear prediction error filter which is computed from the averaged spectrum of both signals and flattens it.
+		This makes the peak of the correlation function narrow and allows to get the stable result faster for signals with the dominating
+		low-frequency content like bass or kick drums. Because the same filter is applied to both channels, the delay between them is not changed.
+		The pre-whitening is applied only to the analysis, the output signal remains unchanged. Switching the option resets the accumulated data.
+	</li>
+	<li>
+		<b>Multithread</b> - enables computation of the correlation function by the pool of analysis threads shared between all instances of the plugin.
+		The range of offsets is split into parts which are computed simultaneously by the audio thread and worker threads, so the results
+		are always ready at the end of the processed block and do not differ from the single-threaded computation. The number of worker threads
+		is limited by the number of CPU cores, and instances are served in turn. If some worker thread does not finish its part in time,
+		the audio thread computes that part itself, so a preempted worker thread does not delay the audio processing. This option is useful for long analysis times or many simultaneously
+		working instances, for short analysis times the overhead of synchronization may exceed the benefit.
+		The worker threads are started only when the option is enabled for the first time, idle worker threads sleep and do not consume CPU.
+	</li>
+	<li>
+		<b>Warm start</b> - enables periodic saving of the accumulated correlation function to the state of the plugin. When the state is loaded,
+		the analyser resumes from the saved correlation function instead of starting from scratch, so the detected values are available immediately.
+		The saved state is used only if the sample rate, the <b>Time</b> and the lag range match the current configuration.
+		The state is saved every few seconds, so it reflects the last few seconds of analysis before saving the project.
+	</li>
 </ul>
 
+<p><b>Accumulators:</b></p>
+<p>Additional accumulators allow to watch the correlation function averaged with different reactivity at the same time, for example the fast estimate
+for quick response and the slow estimate for stability. All accumulators share the single computation of the correlation function, so each
+additional accumulator adds only a small part of CPU utilization. The function of each enabled accumulator is displayed on the correlation graph
+with its own color.</p>
+<ul>
+	<li><b>Enable</b> - enables the accumulator.</li>
+	<li><b>Reactivity</b> - the reactivity of the accumulator, has the same meaning as the main <b>Reactivity</b> control.</li>
+	<li><b>Best</b>, <b>Worst</b> - the time and the normalized value of the correlation function for the best and the worst offsets of the accumulator.</li>
+</ul>
+
+<p><b>Spectral analysis:</b></p>
+<ul>
+	<li>
+		<b>Enable</b> - enables the spectral analysis of both inputs. The cross-spectrum and power spectrums of inputs are computed
+		with single short-time Fourier transform of each channel and averaged with the same <b>Reactivity</b> as the correlation function.
+	</li>
+</ul>
+<p>The <b>Coherence</b> graph displays the magnitude-squared coherence between two inputs depending on the frequency. Values near to 1 mean that
+the signal in the corresponding frequency band is present in both channels, values near to 0 mean that the signals are unrelated.</p>
+<p>The <b>Group delay</b> graph displays the delay between two inputs depending on the frequency, estimated from the slope of the cross-spectrum phase.
+The sign of the delay matches the sign of offsets displayed in the monitoring section. Frequency-dependent delay is usually caused by crossovers
+or different microphone placement. The values of group delay are reliable only for bands with high coherence.</p>
+
+<p><b>Active measurement:</b></p>
+<ul>
+	<li>
+		<b>Enable</b> - enables the active measurement mode. Both outputs emit the maximum length sequence (MLS) test signal instead of the input signal,
+		and the response of the measured system is taken from the input <b>B</b>. The correlation of the response with the known test signal
+		is computed once per each period of the sequence with the fast Hadamard transform, so the delay is detected in a fraction of second
+		with much lower CPU utilization than in the passive mode. The period of the sequence is automatically chosen to cover the whole analysis time,
+		the response to the first period is skipped to let the measured system settle. The delay of the measured system should not exceed the <b>Time</b>.
+		The outputs are smoothly crossfaded between the input signal and the test signal when the mode is switched on or off.
+	</li>
+	<li><b>Level</b> - the level of the test signal.</li>
+</ul>
+
+<p><b>Telemetry:</b></p>
+<ul>
+	<li><b>Enable</b> - enables periodic recording of the detection results to the telemetry file.</li>
+	<li><b>Interval</b> - the time interval between two subsequent records.</li>
+	<li>
+		<b>File</b> - the path to the telemetry file. The records are appended to the end of file in the CSV format, so the file can be monitored by
+		external tools while the plugin is running. Each record contains the wall clock time in seconds, the number of processed samples since start,
+		the <b>Best</b>, <b>Selected</b> and <b>Worst</b> offsets in samples, the correlation value at the <b>Best</b> offset and the confidence of the
+		<b>Best</b> offset.
+	</li>
+</ul>
+
+<p>The plugin does not require the user interface for operation, so it can be used for headless monitoring of alignment between two feeds,
+for example as the GStreamer element. The audio passes through unchanged only while <b>Auto align</b> and <b>Active</b> are turned off.
+The detection results are delivered by the telemetry file and, for hosts that support MIDI, by the MIDI controller messages,
+the rate of the results is defined by the <b>Hop</b> and the telemetry <b>Interval</b> controls.</p>
+
 <p><b>Meters:</b></p>
 <ul>
 	<li><b>Best</b> - row of the monitoring section, displays values for the best detected phase that gives the best value from the correlation function set.</li>
@@ -40,6 +141,16 @@ by lowering the maximum analysis time.<p>
 	<li><b>Offset</b> - column of the monitoring section, displays the sample difference between two input channels for the correlation function value.</li>
 	<li><b>Distance</b> - column of the monitoring section, displays the relative to the sound speed distance difference between two input channels for the correlation function value.</li>
 	<li><b>Value</b> - column of the monitoring section, displays the normalized value of the correlation function.</li>
+	<li>
+		<b>Peaks</b> - the table of secondary local maximums (green) and minimums (red) of the correlation function sorted by their absolute value.
+		Secondary peaks usually correspond to reflections or additional signal paths. They are also displayed on the graph as thin vertical lines,
+		the rows of the table without a detected peak are shown as zero and have no line on the graph.
+	</li>
+	<li>
+		<b>Confidence</b> - the peak-to-sidelobe estimate for the <b>Best</b> offset. The value near to 1 means that the best peak is much higher than
+		any secondary peak, the value near to 0 means that there are secondary peaks of almost the same level, so the detected offset is ambiguous.
+	</li>
+	<li><b>Delay</b> - the delay currently applied by the automatic alignment, positive values mean that the channel <b>B</b> is delayed, negative - that the channel <b>A</b> is delayed.</li>
 </ul>
 
 <p>The <b>Correlation Graph</b> is two-dimensional graph that allows to monitor immediate values of the set of correlation functions.
@@ -26,7 +26,7 @@
 
 #define LSP_PLUGINS_PHASE_DETECTOR_VERSION_MAJOR         1
 #define LSP_PLUGINS_PHASE_DETECTOR_VERSION_MINOR         0
-#define LSP_PLUGINS_PHASE_DETECTOR_VERSION_MICRO         31
+#define LSP_PLUGINS_PHASE_DETECTOR_VERSION_MICRO         32
 
 #define LSP_PLUGINS_PHASE_DETECTOR_VERSION  \
     LSP_MODULE_VERSION( \
@@ -41,6 +41,21 @@ namespace lsp
     {
         //-------------------------------------------------------------------------
         // Phase detector
+        #define PD_EXTREMUM_METERS(id, label) \
+            METERZ("p" id "_t", "Peak " label " time", U_MSEC, phase_detector_metadata::TIME), \
+            METERZ("p" id "_v", "Peak " label " value", U_NONE, phase_detector_metadata::VALUE), \
+            METERZ("d" id "_t", "Dip " label " time", U_MSEC, phase_detector_metadata::TIME), \
+            METERZ("d" id "_v", "Dip " label " value", U_NONE, phase_detector_metadata::VALUE)
+
+        #define PD_ACCUMULATOR(id, label) \
+            SWITCH("ae" id, "Accumulator " label " enable", "Acc " label " on", 0.0f), \
+            LOG_CONTROL("react" id, "Accumulator " label " reactivity", "Reactivity " label, U_SEC, phase_detector_metadata::REACT_TIME), \
+            METERZ("ab" id "_t", "Accumulator " label " best time", U_MSEC, phase_detector_metadata::TIME), \
+            METERZ("ab" id "_v", "Accumulator " label " best value", U_NONE, phase_detector_metadata::VALUE), \
+            METERZ("aw" id "_t", "Accumulator " label " worst time", U_MSEC, phase_detector_metadata::TIME), \
+            METERZ("aw" id "_v", "Accumulator " label " worst value", U_NONE, phase_detector_metadata::VALUE), \
+            MESH("f" id, "Accumulator " label " function", 2, phase_detector_metadata::MESH_POINTS)
+
         static const port_t phase_detector_ports[] =
         {
             // Input audio ports
@@ -76,6 +91,40 @@ namespace lsp
 
             MESH("f", "Function", 2, phase_detector_metadata::MESH_POINTS),
 
+            // Additional ports, placed after the original ports to keep their indices
+            MIDI_OUTPUT,
+
+            // Additional input controls
+            LOG_CONTROL("hop", "Analysis hop", "Hop", U_MSEC, phase_detector_metadata::HOP_TIME),
+            CONTROL("lmin", "Minimum lag", "Min lag", U_PERCENT, phase_detector_metadata::LAG_MIN),
+            CONTROL("lmax", "Maximum lag", "Max lag", U_PERCENT, phase_detector_metadata::LAG_MAX),
+            SWITCH("align", "Automatic alignment", "Auto align", 0.0f),
+            SWITCH("apol", "Polarity correction", "Polarity fix", 0.0f),
+            SWITCH("spec", "Spectral analysis", "Spectral", 0.0f),
+            SWITCH("pw", "Pre-whitening", "Pre-whiten", 0.0f),
+            SWITCH("mt", "Multithreaded analysis", "Multithread", 0.0f),
+            SWITCH("act", "Active measurement", "Active", 0.0f),
+            LOG_CONTROL("act_l", "Excitation level", "Exc level", U_GAIN_AMP, phase_detector_metadata::EXCITATION_LEVEL),
+            SWITCH("warm", "Warm start", "Warm start", 0.0f),
+            SWITCH("tlm", "Telemetry", "Telemetry", 0.0f),
+            LOG_CONTROL("tlm_i", "Telemetry interval", "Tlm interval", U_SEC, phase_detector_metadata::TELEMETRY_INTERVAL),
+            PATH("tlm_f", "Telemetry file", "Tlm file"),
+
+            // Additional output controls
+            METERZ("a_t", "Alignment time", U_MSEC, phase_detector_metadata::TIME),
+            METER("conf", "Confidence", U_NONE, phase_detector_metadata::CONFIDENCE),
+            METER("np", "Number of secondary peaks", U_NONE, phase_detector_metadata::EXTREMUMS),
+            METER("nd", "Number of secondary dips", U_NONE, phase_detector_metadata::EXTREMUMS),
+            PD_EXTREMUM_METERS("1", "1"),
+            PD_EXTREMUM_METERS("2", "2"),
+            PD_EXTREMUM_METERS("3", "3"),
+
+            MESH("msc", "Coherence", 2, phase_detector_metadata::SPECTRUM_POINTS),
+            MESH("gd", "Group delay", 2, phase_detector_metadata::SPECTRUM_POINTS),
+
+            PD_ACCUMULATOR("1", "1"),
+            PD_ACCUMULATOR("2", "2"),
+
             PORTS_END
         };
 
@@ -127,7 +176,7 @@ namespace lsp
             LSP_PLUGINS_PHASE_DETECTOR_VERSION,
             plugin_classes,
             clap_features,
-            E_DUMP_STATE | E_INLINE_DISPLAY,
+            E_DUMP_STATE | E_INLINE_DISPLAY | E_KVT_SYNC,
             phase_detector_ports,
             "plugins/util/phase_detector.xml",
             NULL,
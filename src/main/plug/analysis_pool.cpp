@@ -0,0 +1,526 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-phase-detector
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-plugins-phase-detector is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-phase-detector is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-phase-detector. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/plugins/analysis_pool.h>
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/common/finally.h>
+#include <lsp-plug.in/dsp/dsp.h>
+
+#ifdef PLATFORM_WINDOWS
+    #include <windows.h>
+#else
+    #include <pthread.h>
+    #include <time.h>
+#endif /* PLATFORM_WINDOWS */
+
+namespace lsp
+{
+    namespace plugins
+    {
+        static constexpr size_t     IDLE_SPINS      = 0x100;        // Number of idle scans before worker goes to sleep
+
+        /**
+         * Monotonic time used for chunk timing and deadlines: unlike the wall clock, it does not
+         * jump on system time adjustments
+         */
+        static inline wsize_t get_time_nanos()
+        {
+        #ifdef PLATFORM_WINDOWS
+            static LARGE_INTEGER freq = { 0 };
+            if (freq.QuadPart == 0)
+                QueryPerformanceFrequency(&freq);
+
+            LARGE_INTEGER counter;
+            QueryPerformanceCounter(&counter);
+            const wsize_t ticks = counter.QuadPart;
+            const wsize_t rate  = freq.QuadPart;
+            return (ticks / rate) * 1000000000u + ((ticks % rate) * 1000000000u) / rate;
+        #else
+            struct timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return wsize_t(ts.tv_sec) * 1000000000u + ts.tv_nsec;
+        #endif /* PLATFORM_WINDOWS */
+        }
+
+        /**
+         * The wake-up event for idle workers: the condition variable signalled on each published job
+         */
+        struct analysis_pool::wakeup_t
+        {
+        #ifdef PLATFORM_WINDOWS
+            CRITICAL_SECTION    sMutex;
+            CONDITION_VARIABLE  sCond;
+        #else
+            pthread_mutex_t     sMutex;
+            pthread_cond_t      sCond;
+        #endif /* PLATFORM_WINDOWS */
+        };
+
+        ipc::Mutex      analysis_pool::sLock;
+        analysis_pool  *analysis_pool::pInstance    = NULL;
+        size_t          analysis_pool::nReferences  = 0;
+
+        //---------------------------------------------------------------------
+        analysis_pool::IJob::~IJob()
+        {
+        }
+
+        //---------------------------------------------------------------------
+        analysis_pool::Worker::Worker(analysis_pool *pool, size_t first)
+        {
+            pPool       = pool;
+            nFirst      = first;
+        }
+
+        analysis_pool::Worker::~Worker()
+        {
+            pPool       = NULL;
+        }
+
+        status_t analysis_pool::Worker::run()
+        {
+            size_t idle     = 0;
+            size_t slot     = nFirst;
+
+            // Use the same floating-point mode as the audio thread: flush denormals to zero
+            dsp::context_t ctx;
+            dsp::start(&ctx);
+            lsp_finally { dsp::finish(&ctx); };
+
+            while (!is_cancelled())
+            {
+                // Remember the generation before scanning to not miss the job published during the scan
+                const uatomic_t generation  = atomic_load(&pPool->nGeneration);
+
+                // Scan slots in round-robin order starting with the one next to the last processed
+                bool processed  = false;
+                const size_t count  = pPool->nSlots;
+                for (size_t i=0; i<count; ++i)
+                {
+                    slot            = (slot + 1) % count;
+                    if (pPool->process_slot(slot))
+                    {
+                        processed       = true;
+                        break;
+                    }
+                }
+
+                if (processed)
+                    idle            = 0;
+                else if ((++idle) < IDLE_SPINS)
+                    ipc::Thread::yield();
+                else
+                {
+                    pPool->wait_job(generation);
+                    idle            = 0;
+                }
+            }
+
+            return STATUS_OK;
+        }
+
+        //---------------------------------------------------------------------
+        analysis_pool::analysis_pool()
+        {
+            for (size_t i=0; i<SLOTS_MAX; ++i)
+            {
+                slot_t *s       = &vSlots[i];
+                s->pJob         = NULL;
+                s->nChunks      = 0;
+                s->nReady       = 0;
+                s->nUsers       = 0;
+                for (size_t j=0; j<CHUNKS_MAX; ++j)
+                    s->vState[j]    = CS_IDLE;
+                s->nChunkTime   = 0;
+                s->bUsed        = false;
+            }
+            for (size_t i=0; i<THREADS_MAX; ++i)
+                vWorkers[i]     = NULL;
+
+            nWorkers        = 0;
+            nSlots          = 0;
+            nGeneration     = 0;
+            pWakeup         = NULL;
+        }
+
+        analysis_pool::~analysis_pool()
+        {
+            stop();
+        }
+
+        void analysis_pool::wait_job(uatomic_t generation)
+        {
+            wakeup_t *w     = pWakeup;
+
+        #ifdef PLATFORM_WINDOWS
+            EnterCriticalSection(&w->sMutex);
+            if (atomic_load(&nGeneration) == generation)
+                SleepConditionVariableCS(&w->sCond, &w->sMutex, IDLE_TIMEOUT);
+            LeaveCriticalSection(&w->sMutex);
+        #else
+            struct timespec ts;
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_sec      += IDLE_TIMEOUT / 1000;
+            ts.tv_nsec     += (IDLE_TIMEOUT % 1000) * 1000000;
+            if (ts.tv_nsec >= 1000000000)
+            {
+                ts.tv_nsec     -= 1000000000;
+                ++ts.tv_sec;
+            }
+
+            pthread_mutex_lock(&w->sMutex);
+            if (atomic_load(&nGeneration) == generation)
+                pthread_cond_timedwait(&w->sCond, &w->sMutex, &ts);
+            pthread_mutex_unlock(&w->sMutex);
+        #endif /* PLATFORM_WINDOWS */
+        }
+
+        void analysis_pool::wake_workers()
+        {
+            atomic_add(&nGeneration, 1);
+
+            /*
+             * The caller may be the audio thread, so it never blocks on the mutex. If the mutex
+             * is held by the worker which is going to sleep, the wake-up is missed, but the worker
+             * wakes up by the timeout, and the job is anyway completed by the calling thread.
+             */
+            wakeup_t *w     = pWakeup;
+        #ifdef PLATFORM_WINDOWS
+            if (TryEnterCriticalSection(&w->sMutex))
+            {
+                WakeAllConditionVariable(&w->sCond);
+                LeaveCriticalSection(&w->sMutex);
+            }
+        #else
+            if (pthread_mutex_trylock(&w->sMutex) == 0)
+            {
+                pthread_cond_broadcast(&w->sCond);
+                pthread_mutex_unlock(&w->sMutex);
+            }
+        #endif /* PLATFORM_WINDOWS */
+        }
+
+        bool analysis_pool::start()
+        {
+            // Leave one core for the audio thread
+            size_t cores    = ipc::Thread::system_cores();
+            size_t threads  = lsp_min((cores > 1) ? cores - 1 : 0, THREADS_MAX);
+            lsp_trace("Starting analysis pool with %d threads", int(threads));
+            if (threads <= 0)
+                return false;
+
+            // Initialize the wake-up event
+            wakeup_t *w     = new wakeup_t;
+            if (w == NULL)
+                return false;
+        #ifdef PLATFORM_WINDOWS
+            InitializeCriticalSection(&w->sMutex);
+            InitializeConditionVariable(&w->sCond);
+        #else
+            pthread_mutex_init(&w->sMutex, NULL);
+            pthread_cond_init(&w->sCond, NULL);
+        #endif /* PLATFORM_WINDOWS */
+            pWakeup         = w;
+
+            for (size_t i=0; i<threads; ++i)
+            {
+                Worker *w       = new Worker(this, i);
+                if (w == NULL)
+                    break;
+                if (w->start() != STATUS_OK)
+                {
+                    delete w;
+                    break;
+                }
+                vWorkers[nWorkers++]    = w;
+            }
+
+            return nWorkers > 0;
+        }
+
+        void analysis_pool::stop()
+        {
+            lsp_trace("Stopping analysis pool");
+
+            for (size_t i=0; i<nWorkers; ++i)
+                vWorkers[i]->cancel();
+
+            if (pWakeup != NULL)
+            {
+                // Wake up all sleeping workers, the mutex can be locked here
+                wakeup_t *w     = pWakeup;
+                atomic_add(&nGeneration, 1);
+            #ifdef PLATFORM_WINDOWS
+                EnterCriticalSection(&w->sMutex);
+                WakeAllConditionVariable(&w->sCond);
+                LeaveCriticalSection(&w->sMutex);
+            #else
+                pthread_mutex_lock(&w->sMutex);
+                pthread_cond_broadcast(&w->sCond);
+                pthread_mutex_unlock(&w->sMutex);
+            #endif /* PLATFORM_WINDOWS */
+            }
+
+            for (size_t i=0; i<nWorkers; ++i)
+            {
+                vWorkers[i]->join();
+                delete vWorkers[i];
+                vWorkers[i]     = NULL;
+            }
+            nWorkers        = 0;
+
+            if (pWakeup != NULL)
+            {
+                wakeup_t *w     = pWakeup;
+            #ifdef PLATFORM_WINDOWS
+                DeleteCriticalSection(&w->sMutex);
+            #else
+                pthread_cond_destroy(&w->sCond);
+                pthread_mutex_destroy(&w->sMutex);
+            #endif /* PLATFORM_WINDOWS */
+                delete w;
+                pWakeup         = NULL;
+            }
+        }
+
+        bool analysis_pool::process_slot(size_t index)
+        {
+            slot_t *s       = &vSlots[index];
+
+            // Fast check without modifying the state of the slot
+            if (atomic_load(&s->nReady) <= 0)
+                return false;
+
+            // The owner of the slot does not release the data until there are users of the slot
+            atomic_add(&s->nUsers, 1);
+            lsp_finally { atomic_add(&s->nUsers, -1); };
+
+            // Take the first available chunk
+            const size_t chunks = lsp_min(s->nChunks, CHUNKS_MAX);
+            for (size_t i=0; i<chunks; ++i)
+            {
+                if (!atomic_cas(&s->vState[i], CS_READY, CS_BUSY))
+                    continue;
+                atomic_add(&s->nReady, -1);
+
+                s->pJob->compute_chunk(i);
+
+                // If the chunk has been taken back by the owner, drop the result and release the storage
+                if (!atomic_cas(&s->vState[i], CS_BUSY, CS_DONE))
+                    atomic_store(&s->vState[i], CS_IDLE);
+
+                return true;
+            }
+
+            return false;
+        }
+
+        ssize_t analysis_pool::connect()
+        {
+            if (!sLock.lock())
+                return -1;
+            lsp_finally { sLock.unlock(); };
+
+            // Create the pool on the first connection
+            if (pInstance == NULL)
+            {
+                analysis_pool *pool = new analysis_pool();
+                if (pool == NULL)
+                    return -1;
+                if (!pool->start())
+                {
+                    delete pool;
+                    return -1;
+                }
+                pInstance       = pool;
+            }
+
+            // Allocate the slot
+            for (size_t i=0; i<SLOTS_MAX; ++i)
+            {
+                slot_t *s       = &pInstance->vSlots[i];
+                if (s->bUsed)
+                    continue;
+
+                s->bUsed        = true;
+                ++nReferences;
+                if (pInstance->nSlots <= i)
+                    pInstance->nSlots   = i + 1;
+
+                return i;
+            }
+
+            // No free slots, the pool can not be used
+            if (nReferences <= 0)
+            {
+                delete pInstance;
+                pInstance       = NULL;
+            }
+
+            return -1;
+        }
+
+        void analysis_pool::disconnect(ssize_t id)
+        {
+            if ((id < 0) || (size_t(id) >= SLOTS_MAX))
+                return;
+
+            if (!sLock.lock())
+                return;
+            lsp_finally { sLock.unlock(); };
+
+            if (pInstance == NULL)
+                return;
+
+            // Release the slot when all workers leave it
+            slot_t *s       = &pInstance->vSlots[id];
+            if (!s->bUsed)
+                return;
+            while (atomic_load(&s->nUsers) > 0)
+                ipc::Thread::sleep(1);
+
+            s->pJob         = NULL;
+            s->nChunks      = 0;
+            for (size_t i=0; i<CHUNKS_MAX; ++i)
+                s->vState[i]    = CS_IDLE;
+            s->nChunkTime   = 0;
+            s->bUsed        = false;
+
+            // Destroy the pool on the last disconnection
+            if ((--nReferences) <= 0)
+            {
+                delete pInstance;
+                pInstance       = NULL;
+            }
+        }
+
+        void analysis_pool::execute(ssize_t id, IJob *job, size_t chunks)
+        {
+            // The pool remains alive while the caller is connected
+            analysis_pool *pool = pInstance;
+            if ((id < 0) || (pool == NULL) || (chunks <= 1) || (chunks > CHUNKS_MAX))
+            {
+                for (size_t i=0; i<chunks; ++i)
+                    job->run_chunk(i);
+                return;
+            }
+
+            // Publish the job. Chunks taken back during the previous call may still be
+            // processed by late workers, their storage is busy, so process them in place.
+            slot_t *s       = &pool->vSlots[id];
+            uint64_t local  = 0;
+            uatomic_t ready = 0;
+            s->pJob         = job;
+            s->nChunks      = chunks;
+            for (size_t i=0; i<chunks; ++i)
+            {
+                if (atomic_load(&s->vState[i]) == CS_IDLE)
+                {
+                    job->prepare_chunk(i);
+                    if (atomic_cas(&s->vState[i], CS_IDLE, CS_READY))
+                    {
+                        ++ready;
+                        continue;
+                    }
+                }
+                local          |= uint64_t(1) << i;
+            }
+            atomic_add(&s->nReady, ready);
+            pool->wake_workers();
+
+            // Process chunks in the calling thread and measure the average time of one chunk
+            size_t processed    = 0;
+            wsize_t time        = get_time_nanos();
+            for (size_t i=0; i<chunks; ++i)
+            {
+                if (local & (uint64_t(1) << i))
+                    job->run_chunk(i);
+                else if (atomic_cas(&s->vState[i], CS_READY, CS_IDLE))
+                {
+                    atomic_add(&s->nReady, -1);
+                    job->run_chunk(i);
+                }
+                else
+                    continue;
+                ++processed;
+            }
+
+            wsize_t now         = get_time_nanos();
+            if (processed > 0)
+                s->nChunkTime       = (now - time) / processed;
+            const wsize_t deadline  = now + s->nChunkTime * DEADLINE_CHUNKS;
+
+            // Commit chunks processed by workers, take back chunks not finished before the deadline
+            while (true)
+            {
+                const bool expired  = now >= deadline;
+                bool pending        = false;
+
+                for (size_t i=0; i<chunks; ++i)
+                {
+                    if (local & (uint64_t(1) << i))
+                        continue;
+
+                    const uatomic_t state   = atomic_load(&s->vState[i]);
+                    if (state == CS_DONE)
+                    {
+                        job->commit_chunk(i);
+                        atomic_store(&s->vState[i], CS_IDLE);
+                    }
+                    else if (state == CS_BUSY)
+                    {
+                        if (!expired)
+                            pending         = true;
+                        else if (atomic_cas(&s->vState[i], CS_BUSY, CS_LOST))
+                        {
+                            lsp_trace("chunk %d taken back from worker", int(i));
+                            job->run_chunk(i);
+                        }
+                        else
+                        {
+                            // The worker has just finished the chunk
+                            job->commit_chunk(i);
+                            atomic_store(&s->vState[i], CS_IDLE);
+                        }
+                    }
+                }
+
+                if (!pending)
+                    break;
+
+                ipc::Thread::yield();
+                now                 = get_time_nanos();
+            }
+        }
+
+        void analysis_pool::wait(ssize_t id)
+        {
+            analysis_pool *pool = pInstance;
+            if ((id < 0) || (size_t(id) >= SLOTS_MAX) || (pool == NULL))
+                return;
+
+            slot_t *s       = &pool->vSlots[id];
+            while (atomic_load(&s->nUsers) > 0)
+                ipc::Thread::sleep(1);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
@@ -21,10 +21,19 @@
 
 #include <private/plugins/phase_detector.h>
 #include <lsp-plug.in/dsp-units/units.h>
+#include <lsp-plug.in/dsp-units/misc/windows.h>
 #include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/common/bits.h>
 #include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/common/endian.h>
+#include <lsp-plug.in/common/finally.h>
 #include <lsp-plug.in/stdlib/math.h>
 #include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/ipc/Thread.h>
+#include <lsp-plug.in/protocol/midi.h>
+#include <lsp-plug.in/runtime/system.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/string.h>
 
 #include <lsp-plug.in/shared/id_colors.h>
 
@@ -38,6 +47,28 @@ namespace lsp
             return p;
         }
 
+        //---------------------------------------------------------------------
+        // Feedback taps of maximum length sequences of order MLS_ORDER_MIN..MLS_ORDER_MAX, zero-terminated
+        static const uint8_t mls_taps[][5] =
+        {
+            { 10, 7, 0 },
+            { 11, 9, 0 },
+            { 12, 6, 4, 1, 0 },
+            { 13, 4, 3, 1, 0 },
+            { 14, 5, 3, 1, 0 },
+            { 15, 14, 0 },
+            { 16, 15, 13, 4, 0 },
+            { 17, 14, 0 },
+            { 18, 11, 0 }
+        };
+
+        //---------------------------------------------------------------------
+        // Warm state stored in the KVT
+        static constexpr uint32_t WARM_STATE_MAGIC  = 0x50445753;   // 'PDWS'
+        static const char *WARM_STATE_KVT           = "/warm_state";
+        static const char *WARM_STATE_CTYPE         = "application/x-lsp-phase-detector-state";
+        static constexpr size_t TASK_WAIT_TIMEOUT   = 500;          // Maximum time to wait for a background task, ms
+
         //---------------------------------------------------------------------
         // Plugin factory
         static const meta::plugin_t *plugins[] =
@@ -52,10 +83,112 @@ namespace lsp
 
         static plug::Factory factory(plugin_factory, plugins, 1);
 
+        //---------------------------------------------------------------------
+        // Telemetry writer
+        phase_detector::TelemetryWriter::TelemetryWriter(phase_detector *core)
+        {
+            pCore       = core;
+        }
+
+        phase_detector::TelemetryWriter::~TelemetryWriter()
+        {
+            pCore       = NULL;
+        }
+
+        status_t phase_detector::TelemetryWriter::run()
+        {
+            return pCore->write_telemetry();
+        }
+
+        //---------------------------------------------------------------------
+        // Warm state writer
+        phase_detector::WarmStateWriter::WarmStateWriter(phase_detector *core)
+        {
+            pCore       = core;
+            pData       = NULL;
+            nSize       = 0;
+        }
+
+        phase_detector::WarmStateWriter::~WarmStateWriter()
+        {
+            pCore       = NULL;
+            pData       = NULL;
+            nSize       = 0;
+        }
+
+        void phase_detector::WarmStateWriter::bind(const uint8_t *data, size_t size)
+        {
+            pData       = data;
+            nSize       = size;
+        }
+
+        status_t phase_detector::WarmStateWriter::run()
+        {
+            return pCore->write_warm_state(pData, nSize);
+        }
+
+        //---------------------------------------------------------------------
+        // Analysis pool connector
+        phase_detector::PoolConnector::PoolConnector(phase_detector *core)
+        {
+            pCore       = core;
+        }
+
+        phase_detector::PoolConnector::~PoolConnector()
+        {
+            pCore       = NULL;
+        }
+
+        status_t phase_detector::PoolConnector::run()
+        {
+            return pCore->connect_pool();
+        }
+
+        //---------------------------------------------------------------------
+        // Correlation update job
+        phase_detector::CorrelationJob::CorrelationJob(phase_detector *core)
+        {
+            pCore       = core;
+        }
+
+        phase_detector::CorrelationJob::~CorrelationJob()
+        {
+            pCore       = NULL;
+        }
+
+        void phase_detector::CorrelationJob::run_chunk(size_t index)
+        {
+            // Each chunk updates the independent range of lags
+            const size_t first  = pCore->nFuncFirst + index * meta::phase_detector_metadata::MT_CHUNK_SIZE;
+            const size_t last   = pCore->nFuncFirst + pCore->nFuncCount;
+            pCore->update_function(first, lsp_min(last - first, meta::phase_detector_metadata::MT_CHUNK_SIZE));
+        }
+
+        void phase_detector::CorrelationJob::prepare_chunk(size_t index)
+        {
+            const size_t first  = pCore->nFuncFirst + index * meta::phase_detector_metadata::MT_CHUNK_SIZE;
+            const size_t last   = pCore->nFuncFirst + pCore->nFuncCount;
+            pCore->init_chunk(&pCore->vChunks[index], first, lsp_min(last - first, meta::phase_detector_metadata::MT_CHUNK_SIZE));
+        }
+
+        void phase_detector::CorrelationJob::compute_chunk(size_t index)
+        {
+            pCore->compute_chunk(&pCore->vChunks[index]);
+        }
+
+        void phase_detector::CorrelationJob::commit_chunk(size_t index)
+        {
+            pCore->commit_chunk(&pCore->vChunks[index]);
+        }
+
         //---------------------------------------------------------------------
         // Implementation
         phase_detector::phase_detector(const meta::plugin_t *meta):
-            Module(meta)
+            Module(meta),
+            sTlmWriter(this),
+            sCorrJob(this),
+            sPoolConnector(this),
+            sWarmWriter(this)
         {
             fTimeInterval       = meta::phase_detector_metadata::DETECT_TIME_DFL;
             fReactivity         = meta::phase_detector_metadata::REACT_TIME_DFL;
@@ -67,6 +200,10 @@ namespace lsp
             nMaxVectorSize      = 0;
             nVectorSize         = 0;
             nFuncSize           = 0;
+            nFuncFirst          = 0;
+            nFuncCount          = 0;
+            fLagMin             = meta::phase_detector_metadata::LAG_MIN_DFL;
+            fLagMax             = meta::phase_detector_metadata::LAG_MAX_DFL;
 
             nGapSize            = 0;
             nMaxGapSize         = 0;
@@ -81,19 +218,168 @@ namespace lsp
             vB.nSize            = 0;
             vB.pData            = NULL;
 
+            for (size_t i=0; i<2; ++i)
+            {
+                channel_t *c        = &vChannels[i];
+                c->fGain[0]         = 1.0f;
+                c->fGain[1]         = 1.0f;
+                c->vBuffer          = NULL;
+            }
+
+            fBestValue          = 0.0f;
+            fSelectedValue      = 0.0f;
+            fWorstValue         = 0.0f;
+            fConfidence         = 0.0f;
+            nPeaks              = 0;
+            nDips               = 0;
+            for (size_t i=0; i<meta::phase_detector_metadata::PEAKS_MAX; ++i)
+            {
+                vPeaks[i].nIndex    = 0;
+                vPeaks[i].fValue    = 0.0f;
+                vDips[i].nIndex     = 0;
+                vDips[i].fValue     = 0.0f;
+            }
+            for (size_t i=0; i<meta::phase_detector_metadata::ACCUMULATORS; ++i)
+            {
+                accumulator_t *acc  = &vAccumulators[i];
+                acc->vData          = NULL;
+                acc->fReactivity    = meta::phase_detector_metadata::REACT_TIME_DFL;
+                acc->fTau           = 0.0f;
+                acc->fPeriodTau     = 1.0f;
+                acc->fNorm          = 0.0f;
+                acc->nBest          = 0;
+                acc->nWorst         = 0;
+                acc->fBestValue     = 0.0f;
+                acc->fWorstValue    = 0.0f;
+                acc->bEnabled       = false;
+
+                acc->pEnabled       = NULL;
+                acc->pReactivity    = NULL;
+                acc->pBestTime      = NULL;
+                acc->pBestValue     = NULL;
+                acc->pWorstTime     = NULL;
+                acc->pWorstValue    = NULL;
+                acc->pFunction      = NULL;
+            }
+
+            nAlign              = 0;
+            bAlignInv           = false;
+            nAlignReq           = 0;
+            bAlignReqInv        = false;
+            nAlignHold          = 0;
+            nAlignHoldMax       = 0;
+            nActiveLine         = 0;
+            nFadePos            = 0;
+            nFadeLen            = 0;
+
+            nTlmHead            = 0;
+            nTlmTail            = 0;
+            nTlmPosition        = 0;
+            nTlmCounter         = 0;
+            nTlmInterval        = 0;
+            nTlmDropped         = 0;
+            bTelemetry          = false;
+            bTlmReopen          = false;
+            bTlmOpened          = false;
+            sTlmPath[0]         = '\0';
+
+            prewhiten_t *pw     = &sPrewhiten;
+            for (size_t i=0; i<2; ++i)
+            {
+                pw->vBuffer[i]      = NULL;
+                pw->vOut[i]         = NULL;
+            }
+            for (size_t i=0; i<=meta::phase_detector_metadata::PREWHITEN_ORDER; ++i)
+            {
+                pw->vCorr[i]        = 0.0f;
+                pw->vCoeffs[i]      = 0.0f;
+            }
+            pw->vCoeffs[0]      = 1.0f;
+            pw->fLogDecay       = 0.0f;
+            bPrewhiten          = false;
+
+            nPoolId             = -1;
+            nPoolPending        = -1;
+            nJobChunks          = 0;
+            vChunks             = NULL;
+            nChunks             = 0;
+            vChunkData          = NULL;
+            bMultithread        = false;
+
+            sMls.vSignal        = NULL;
+            sMls.vTagS          = NULL;
+            sMls.vTagL          = NULL;
+            sMls.vCapture       = NULL;
+            sMls.vTransform     = NULL;
+            sMls.vExcitation    = NULL;
+            sMls.nOrder         = 0;
+            sMls.nLength        = 0;
+            sMls.nPosition      = 0;
+            sMls.nPeriods       = 0;
+            sMls.fTau           = 1.0f;
+            sMls.fLevel         = meta::phase_detector_metadata::EXCITATION_LEVEL_DFL;
+            bActive             = false;
+            nActiveFade         = 0;
+
+            vWarmState          = NULL;
+            nWarmSize           = 0;
+            vWarmRetired        = NULL;
+            nWarmCounter        = 0;
+            nWarmInterval       = 0;
+            bWarmStart          = false;
+            bWarmLoad           = true;
+
+            for (size_t i=0; i<2; ++i)
+            {
+                sSpectrum.vFrame[i] = NULL;
+                sSpectrum.vFft[i]   = NULL;
+                sSpectrum.vPower[i] = NULL;
+            }
+            sSpectrum.vTemp     = NULL;
+            sSpectrum.vWindow   = NULL;
+            sSpectrum.vCross    = NULL;
+            sSpectrum.nRank     = 0;
+            sSpectrum.nSize     = 0;
+            sSpectrum.nFill     = 0;
+            sSpectrum.fTau      = 1.0f;
+            bSpectral           = false;
+
+            fHopTime            = meta::phase_detector_metadata::HOP_TIME_DFL;
+            nHopSize            = 1;
+            nHopCounter         = 0;
+            nEventBest          = 0;
+            bEventValid         = false;
+
             fTau                = 0.0f;
             fSelector           = meta::phase_detector_metadata::SELECTOR_DFL;
             bBypass             = false;
+            bAlign              = false;
+            bPolarity           = false;
 
             vIn[0]              = NULL;
             vIn[1]              = NULL;
             vOut[0]             = NULL;
             vOut[1]             = NULL;
+            pMidiOut            = NULL;
             pBypass             = NULL;
             pReset              = NULL;
             pSelector           = NULL;
+            pLagMin             = NULL;
+            pLagMax             = NULL;
             pTime               = NULL;
             pReactivity         = NULL;
+            pHop                = NULL;
+            pAlign              = NULL;
+            pPolarity           = NULL;
+            pSpectral           = NULL;
+            pPrewhiten          = NULL;
+            pMultithread        = NULL;
+            pActive             = NULL;
+            pActiveLevel        = NULL;
+            pWarmStart          = NULL;
+            pTelemetry          = NULL;
+            pTlmInterval        = NULL;
+            pTlmFile            = NULL;
 
             for (size_t i=0; i<MK_COUNT; ++i)
             {
@@ -103,7 +389,21 @@ namespace lsp
                 vm->pDistance       = NULL;
                 vm->pValue          = NULL;
             }
+            pAlignTime          = NULL;
+            pConfidence         = NULL;
+            pNumPeaks           = NULL;
+            pNumDips            = NULL;
+            for (size_t i=0; i<meta::phase_detector_metadata::PEAKS_MAX - 1; ++i)
+            {
+                extremum_meters_t *em   = &vExtMeters[i];
+                em->pPeakTime       = NULL;
+                em->pPeakValue      = NULL;
+                em->pDipTime        = NULL;
+                em->pDipValue       = NULL;
+            }
             pFunction           = NULL;
+            pCoherence          = NULL;
+            pGroupDelay         = NULL;
 
             pIDisplay           = NULL;
         }
@@ -147,16 +447,109 @@ namespace lsp
                 vm->pDistance   = TRACE_PORT(ports[port_id++]);
                 vm->pValue      = TRACE_PORT(ports[port_id++]);
             }
-
             pFunction   = TRACE_PORT(ports[port_id++]);
+
+            // Bind additional controls
+            lsp_trace("Binding additional controls");
+            pMidiOut    = TRACE_PORT(ports[port_id++]);
+            pHop        = TRACE_PORT(ports[port_id++]);
+            pLagMin     = TRACE_PORT(ports[port_id++]);
+            pLagMax     = TRACE_PORT(ports[port_id++]);
+            pAlign      = TRACE_PORT(ports[port_id++]);
+            pPolarity   = TRACE_PORT(ports[port_id++]);
+            pSpectral   = TRACE_PORT(ports[port_id++]);
+            pPrewhiten  = TRACE_PORT(ports[port_id++]);
+            pMultithread= TRACE_PORT(ports[port_id++]);
+            pActive     = TRACE_PORT(ports[port_id++]);
+            pActiveLevel= TRACE_PORT(ports[port_id++]);
+            pWarmStart  = TRACE_PORT(ports[port_id++]);
+            pTelemetry  = TRACE_PORT(ports[port_id++]);
+            pTlmInterval= TRACE_PORT(ports[port_id++]);
+            pTlmFile    = TRACE_PORT(ports[port_id++]);
+
+            // Bind additional meters
+            lsp_trace("Binding additional meters");
+            pAlignTime  = TRACE_PORT(ports[port_id++]);
+            pConfidence = TRACE_PORT(ports[port_id++]);
+            pNumPeaks   = TRACE_PORT(ports[port_id++]);
+            pNumDips    = TRACE_PORT(ports[port_id++]);
+            for (size_t i=0; i<meta::phase_detector_metadata::PEAKS_MAX - 1; ++i)
+            {
+                extremum_meters_t *em = &vExtMeters[i];
+
+                em->pPeakTime   = TRACE_PORT(ports[port_id++]);
+                em->pPeakValue  = TRACE_PORT(ports[port_id++]);
+                em->pDipTime    = TRACE_PORT(ports[port_id++]);
+                em->pDipValue   = TRACE_PORT(ports[port_id++]);
+            }
+            pCoherence  = TRACE_PORT(ports[port_id++]);
+            pGroupDelay = TRACE_PORT(ports[port_id++]);
+
+            // Bind accumulators
+            lsp_trace("Binding accumulators");
+            for (size_t i=0; i<meta::phase_detector_metadata::ACCUMULATORS; ++i)
+            {
+                accumulator_t *acc  = &vAccumulators[i];
+
+                acc->pEnabled       = TRACE_PORT(ports[port_id++]);
+                acc->pReactivity    = TRACE_PORT(ports[port_id++]);
+                acc->pBestTime      = TRACE_PORT(ports[port_id++]);
+                acc->pBestValue     = TRACE_PORT(ports[port_id++]);
+                acc->pWorstTime     = TRACE_PORT(ports[port_id++]);
+                acc->pWorstValue    = TRACE_PORT(ports[port_id++]);
+                acc->pFunction      = TRACE_PORT(ports[port_id++]);
+            }
         }
 
         void phase_detector::destroy()
         {
+            // Background tasks access the telemetry file and the KVT storage. The executor may
+            // be stalled or already stopped, so do not wait for them forever: the data of the
+            // task that did not finish in time is abandoned instead of being released
+            const bool tlm_done     = wait_task(&sTlmWriter, TASK_WAIT_TIMEOUT);
+            const bool warm_done    = wait_task(&sWarmWriter, TASK_WAIT_TIMEOUT);
+            const bool pool_done    = wait_task(&sPoolConnector, TASK_WAIT_TIMEOUT);
+            if (sPoolConnector.completed())
+            {
+                nPoolId             = nPoolPending;
+                sPoolConnector.reset();
+            }
+            if (!pool_done)
+                lsp_warn("Analysis pool connection did not finish in time");
+
             do_destroy();
+            if (warm_done)
+                release_warm_state();
+            else
+                lsp_warn("Warm state writer did not finish in time, abandoning the snapshot");
+
+            if (nPoolId >= 0)
+            {
+                analysis_pool::disconnect(nPoolId);
+                nPoolId         = -1;
+            }
+            if (!tlm_done)
+                lsp_warn("Telemetry writer did not finish in time, leaving the file to it");
+            else if (bTlmOpened)
+            {
+                sTlmFile.close();
+                bTlmOpened      = false;
+            }
             Module::destroy();
         }
 
+        bool phase_detector::wait_task(ipc::ITask *task, size_t timeout)
+        {
+            for (size_t i=0; i<timeout; ++i)
+            {
+                if ((task->idle()) || (task->completed()))
+                    return true;
+                ipc::Thread::sleep(1);
+            }
+
+            return (task->idle()) || (task->completed());
+        }
+
         size_t phase_detector::fill_gap(const float *a, const float *b, size_t count)
         {
             lsp_assert(a != NULL);
@@ -208,11 +601,78 @@ namespace lsp
             dsp::fill_zero(vFunction, nMaxVectorSize * 2);
             dsp::fill_zero(vAccumulated, nMaxVectorSize * 2);
             dsp::fill_zero(vNormalized, nMaxVectorSize * 2);
+            for (size_t i=0; i<meta::phase_detector_metadata::ACCUMULATORS; ++i)
+            {
+                accumulator_t *acc  = &vAccumulators[i];
+                dsp::fill_zero(acc->vData, nMaxVectorSize * 2);
+                acc->fNorm          = 0.0f;
+            }
+            nPeaks          = 0;
+            nDips           = 0;
+
+            // Clear spectral analysis
+            clear_spectrum();
+
+            // Restart pre-whitening
+            prewhiten_t *pw = &sPrewhiten;
+            for (size_t i=0; i<2; ++i)
+                dsp::fill_zero(pw->vBuffer[i], meta::phase_detector_metadata::PREWHITEN_ORDER);
+            dsp::fill_zero(pw->vCorr, meta::phase_detector_metadata::PREWHITEN_ORDER + 1);
+            dsp::fill_zero(pw->vCoeffs, meta::phase_detector_metadata::PREWHITEN_ORDER + 1);
+            pw->vCoeffs[0]  = 1.0f;
+
+            // Report the next detected offset
+            nHopCounter     = 0;
+            bEventValid     = false;
+
+            // Restart active measurement
+            mls_t *mls      = &sMls;
+            dsp::fill_zero(mls->vCapture, mls->nLength);
+            mls->nPosition  = 0;
+            mls->nPeriods   = 0;
+        }
+
+        void phase_detector::clear_spectrum()
+        {
+            spectrum_t *sp  = &sSpectrum;
+            const size_t bins = (sp->nSize >> 1) + 1;
+            dsp::fill_zero(sp->vFrame[0], sp->nSize);
+            dsp::fill_zero(sp->vFrame[1], sp->nSize);
+            dsp::fill_zero(sp->vCross, bins * 2);
+            dsp::fill_zero(sp->vPower[0], bins);
+            dsp::fill_zero(sp->vPower[1], bins);
+            sp->nFill       = 0;
         }
 
         void phase_detector::do_destroy()
         {
+            // Late workers may still read buffers of chunks taken back from them
+            analysis_pool::wait(nPoolId);
+
             // Drop previously used buffers
+            if (vChunks != NULL)
+            {
+                delete []   vChunks;
+                vChunks     = NULL;
+            }
+            if (vChunkData != NULL)
+            {
+                delete []   vChunkData;
+                vChunkData  = NULL;
+            }
+            nChunks     = 0;
+            if (vWarmState != NULL)
+            {
+                // Do not block on the warm state writer: if it is still writing the snapshot,
+                // keep the buffer until the writer finishes
+                release_warm_state();
+                if ((sWarmWriter.idle()) || (vWarmRetired != NULL))
+                    delete []   vWarmState;
+                else
+                    vWarmRetired    = vWarmState;
+                vWarmState  = NULL;
+            }
+            nWarmSize   = 0;
             if (vA.pData != NULL)
             {
                 delete []   vA.pData;
@@ -238,6 +698,109 @@ namespace lsp
                 delete []   vNormalized;
                 vNormalized = NULL;
             }
+            for (size_t i=0; i<meta::phase_detector_metadata::ACCUMULATORS; ++i)
+            {
+                accumulator_t *acc  = &vAccumulators[i];
+                if (acc->vData != NULL)
+                {
+                    delete []   acc->vData;
+                    acc->vData      = NULL;
+                }
+            }
+            spectrum_t *sp      = &sSpectrum;
+            for (size_t i=0; i<2; ++i)
+            {
+                if (sp->vFrame[i] != NULL)
+                {
+                    delete []   sp->vFrame[i];
+                    sp->vFrame[i]   = NULL;
+                }
+                if (sp->vFft[i] != NULL)
+                {
+                    delete []   sp->vFft[i];
+                    sp->vFft[i]     = NULL;
+                }
+                if (sp->vPower[i] != NULL)
+                {
+                    delete []   sp->vPower[i];
+                    sp->vPower[i]   = NULL;
+                }
+            }
+            if (sp->vTemp != NULL)
+            {
+                delete []   sp->vTemp;
+                sp->vTemp       = NULL;
+            }
+            if (sp->vWindow != NULL)
+            {
+                delete []   sp->vWindow;
+                sp->vWindow     = NULL;
+            }
+            if (sp->vCross != NULL)
+            {
+                delete []   sp->vCross;
+                sp->vCross      = NULL;
+            }
+            prewhiten_t *pw     = &sPrewhiten;
+            for (size_t i=0; i<2; ++i)
+            {
+                if (pw->vBuffer[i] != NULL)
+                {
+                    delete []   pw->vBuffer[i];
+                    pw->vBuffer[i]  = NULL;
+                }
+                if (pw->vOut[i] != NULL)
+                {
+                    delete []   pw->vOut[i];
+                    pw->vOut[i]     = NULL;
+                }
+            }
+
+            mls_t *mls          = &sMls;
+            if (mls->vSignal != NULL)
+            {
+                delete []   mls->vSignal;
+                mls->vSignal    = NULL;
+            }
+            if (mls->vTagS != NULL)
+            {
+                delete []   mls->vTagS;
+                mls->vTagS      = NULL;
+            }
+            if (mls->vTagL != NULL)
+            {
+                delete []   mls->vTagL;
+                mls->vTagL      = NULL;
+            }
+            if (mls->vCapture != NULL)
+            {
+                delete []   mls->vCapture;
+                mls->vCapture   = NULL;
+            }
+            if (mls->vTransform != NULL)
+            {
+                delete []   mls->vTransform;
+                mls->vTransform = NULL;
+            }
+            if (mls->vExcitation != NULL)
+            {
+                delete []   mls->vExcitation;
+                mls->vExcitation= NULL;
+            }
+            mls->nOrder         = 0;
+            mls->nLength        = 0;
+
+            for (size_t i=0; i<2; ++i)
+            {
+                channel_t *c        = &vChannels[i];
+                c->sLine[0].destroy();
+                c->sLine[1].destroy();
+                if (c->vBuffer != NULL)
+                {
+                    delete []   c->vBuffer;
+                    c->vBuffer  = NULL;
+                }
+            }
             if (pIDisplay != NULL)
             {
                 pIDisplay->destroy();
@@ -263,10 +826,42 @@ namespace lsp
             nGapSize        = 0;
             nGapOffset      = 0;
 
+            set_lag_range(fLagMin, fLagMax, true);
+            generate_mls();
+
             // Yep, clear all buffers
             return true;
         }
 
+        bool phase_detector::set_lag_range(float min, float max, bool force)
+        {
+            if (min > max)
+                lsp::swap(min, max);
+            if ((!force) && (fLagMin == min) && (fLagMax == max))
+                return false;
+
+            lsp_debug("lag range = [%.1f, %.1f]", min, max);
+            fLagMin         = min;
+            fLagMax         = max;
+
+            /*
+             * The lag for index i of the correlation function is (nVectorSize - i),
+             * so the range of lags [min, max] matches the range of indices [nVectorSize - max, nVectorSize - min]
+             */
+            const float k   = nVectorSize * 0.01f;
+            ssize_t first   = ssize_t(nVectorSize) - ssize_t(max * k);
+            ssize_t last    = ssize_t(nVectorSize) - ssize_t(min * k);
+            first           = lsp_limit(first, 0, ssize_t(nFuncSize) - 1);
+            last            = lsp_limit(last, first, ssize_t(nFuncSize) - 1);
+
+            nFuncFirst      = first;
+            nFuncCount      = last - first + 1;
+            nJobChunks      = (nFuncCount + meta::phase_detector_metadata::MT_CHUNK_SIZE - 1) / meta::phase_detector_metadata::MT_CHUNK_SIZE;
+
+            // Clear the whole function because previously not computed elements are not valid
+            return true;
+        }
+
         void phase_detector::set_reactive_interval(float interval)
         {
             lsp_debug("reactivity = %.3f", interval);
@@ -274,6 +869,132 @@ namespace lsp
             // Calculate Reduction
             fReactivity     = interval;
             fTau            = 1.0f - expf(logf(1.0 - M_SQRT1_2) / dspu::seconds_to_samples(fSampleRate, interval));
+
+            // Spectral analysis applies averaging once per each frame
+            const size_t hop    = lsp_max(sSpectrum.nSize >> 1, 1u);
+            sSpectrum.fTau  = 1.0f - expf(logf(1.0 - M_SQRT1_2) / (dspu::seconds_to_samples(fSampleRate, interval) / hop));
+
+            // Active measurement applies averaging once per each period of the sequence
+            const size_t period = lsp_max(sMls.nLength, 1u);
+            sMls.fTau       = 1.0f - expf(logf(1.0 - M_SQRT1_2) / (dspu::seconds_to_samples(fSampleRate, interval) / period));
+        }
+
+        void phase_detector::set_accumulator_reactivity(accumulator_t *acc, float interval)
+        {
+            const size_t period = lsp_max(sMls.nLength, 1u);
+            acc->fReactivity    = interval;
+            acc->fTau           = 1.0f - expf(logf(1.0 - M_SQRT1_2) / dspu::seconds_to_samples(fSampleRate, interval));
+            acc->fPeriodTau     = 1.0f - expf(logf(1.0 - M_SQRT1_2) / (dspu::seconds_to_samples(fSampleRate, interval) / period));
+        }
+
+        void phase_detector::update_alignment(size_t samples)
+        {
+            // Compute the requested alignment
+            ssize_t align       = 0;
+            bool invert         = false;
+            if ((bAlign) && (!bBypass))
+            {
+                // Keep the current alignment until something reliable is detected
+                align               = nAlignReq;
+                invert              = bAlignReqInv;
+
+                if ((bPolarity) && (-fWorstValue > fBestValue))
+                {
+                    // Estimate the confidence of the worst offset the same way as for the best one:
+                    // dips are stored negative, so compare magnitudes of the deepest side dip and the worst value
+                    const float dip     = (nDips > 0) ? lsp_max(-vDips[0].fValue, 0.0f) : 0.0f;
+                    const float conf    = lsp_limit(1.0f - dip / (-fWorstValue), 0.0f, 1.0f);
+                    if (conf >= meta::phase_detector_metadata::ALIGN_CONFIDENCE)
+                    {
+                        align               = nWorst;
+                        invert              = true;
+                    }
+                }
+                else if ((fBestValue > 0.0f) && (fConfidence >= meta::phase_detector_metadata::ALIGN_CONFIDENCE))
+                {
+                    align               = nBest;
+                    invert              = false;
+                }
+            }
+
+            // The requested alignment should remain stable for a while before applying it
+            if ((align != nAlignReq) || (invert != bAlignReqInv))
+            {
+                nAlignReq           = align;
+                bAlignReqInv        = invert;
+                nAlignHold          = 0;
+            }
+            else if (nAlignHold < nAlignHoldMax)
+                nAlignHold         += samples;
+
+            // Check that we need to start the crossfade
+            if (nFadePos < nFadeLen)
+                return;
+            if ((nAlignReq == nAlign) && (bAlignReqInv == bAlignInv))
+                return;
+            if ((bAlign) && (!bBypass) && (nAlignHold < nAlignHoldMax))
+                return;
+
+            // Positive offset means that A comes later than B, so delay B. Otherwise delay A.
+            lsp_trace("alignment change: %d -> %d samples", int(nAlign), int(nAlignReq));
+            const size_t next   = nActiveLine ^ 1;
+            channel_t *a        = &vChannels[0];
+            channel_t *b        = &vChannels[1];
+
+            a->sLine[next].set_delay(lsp_max(-nAlignReq, 0));
+            a->fGain[next]      = 1.0f;
+            b->sLine[next].set_delay(lsp_max(nAlignReq, 0));
+            b->fGain[next]      = (bAlignReqInv) ? -1.0f : 1.0f;
+
+            nAlign              = nAlignReq;
+            bAlignInv           = bAlignReqInv;
+            nFadePos            = 0;
+        }
+
+        void phase_detector::feed_alignment(const float *src, size_t channel, size_t samples)
+        {
+            channel_t *c        = &vChannels[channel];
+
+            for (size_t offset=0; offset < samples; )
+            {
+                size_t to_do        = lsp_min(samples - offset, meta::phase_detector_metadata::ALIGN_BUFFER_SIZE);
+                for (size_t i=0; i<2; ++i)
+                    c->sLine[i].process(c->vBuffer, &src[offset], 1.0f, to_do);
+                offset             += to_do;
+            }
+        }
+
+        void phase_detector::process_alignment(float *dst, const float *src, size_t channel, size_t samples)
+        {
+            channel_t *c        = &vChannels[channel];
+            const size_t curr   = nActiveLine;
+            const size_t next   = curr ^ 1;
+            const bool fading   = nFadePos < nFadeLen;
+            const float k       = 1.0f / nFadeLen;
+            size_t fade         = nFadePos;
+
+            for (size_t offset=0; offset < samples; )
+            {
+                size_t to_do        = lsp_min(samples - offset, meta::phase_detector_metadata::ALIGN_BUFFER_SIZE);
+                const float *in     = &src[offset];
+                float *out          = &dst[offset];
+
+                // Process the fading line first because output buffer may be the same to the input one
+                c->sLine[next].process(c->vBuffer, in, c->fGain[next], to_do);
+                c->sLine[curr].process(out, in, c->fGain[curr], to_do);
+
+                // Apply the crossfade between delay lines
+                if (fading)
+                {
+                    for (size_t i=0; i<to_do; ++i, ++fade)
+                    {
+                        float mix       = (fade < nFadeLen) ? fade * k : 1.0f;
+                        out[i]         += (c->vBuffer[i] - out[i]) * mix;
+                    }
+                }
+
+                offset             += to_do;
+            }
         }
 
         void phase_detector::update_sample_rate(long sr)
@@ -302,9 +1023,106 @@ namespace lsp
             vFunction       = new float[nMaxVectorSize * 2];
             vAccumulated    = new float[nMaxVectorSize * 2];
             vNormalized     = new float[nMaxVectorSize * 2];
+            for (size_t i=0; i<meta::phase_detector_metadata::ACCUMULATORS; ++i)
+                vAccumulators[i].vData  = new float[nMaxVectorSize * 2];
+
+            // Snapshot of the correlation state
+            vWarmState      = new uint8_t[sizeof(warm_header_t) + nMaxVectorSize * 2 * sizeof(float)];
+
+            // Private storage of job chunks: function, accumulated function and accumulators
+            constexpr size_t chunk_size = meta::phase_detector_metadata::MT_CHUNK_SIZE;
+            constexpr size_t chunk_bufs = meta::phase_detector_metadata::ACCUMULATORS + 2;
+            nChunks         = (nMaxVectorSize * 2 + chunk_size - 1) / chunk_size;
+            vChunks         = new corr_chunk_t[nChunks];
+            vChunkData      = new float[nChunks * chunk_bufs * chunk_size];
+            for (size_t i=0; i<nChunks; ++i)
+            {
+                corr_chunk_t *c     = &vChunks[i];
+                float *ptr          = &vChunkData[i * chunk_bufs * chunk_size];
+                c->vFunction        = ptr;
+                c->vAccumulated     = &ptr[chunk_size];
+                for (size_t j=0; j<meta::phase_detector_metadata::ACCUMULATORS; ++j)
+                    c->vAccumulators[j] = &ptr[(j + 2) * chunk_size];
+            }
+
+            // Spectral analysis: FFT frame should cover the whole range of delays
+            spectrum_t *sp  = &sSpectrum;
+            sp->nRank       = meta::phase_detector_metadata::SPECTRUM_RANK_MIN;
+            while ((size_t(1) << sp->nRank) < (nMaxVectorSize * 2))
+                ++sp->nRank;
+            sp->nSize       = size_t(1) << sp->nRank;
+            sp->nFill       = 0;
+            const size_t bins = (sp->nSize >> 1) + 1;
+            for (size_t i=0; i<2; ++i)
+            {
+                sp->vFrame[i]   = new float[sp->nSize];
+                sp->vFft[i]     = new float[sp->nSize * 2];
+                sp->vPower[i]   = new float[bins];
+            }
+            sp->vTemp       = new float[sp->nSize];
+            sp->vWindow     = new float[sp->nSize];
+            sp->vCross      = new float[bins * 2];
+            dspu::windows::window(sp->vWindow, sp->nSize, dspu::windows::HANN);
+
+            // Pre-whitening
+            prewhiten_t *pw = &sPrewhiten;
+            for (size_t i=0; i<2; ++i)
+            {
+                pw->vBuffer[i]  = new float[meta::phase_detector_metadata::PREWHITEN_ORDER + meta::phase_detector_metadata::PREWHITEN_BUFFER_SIZE];
+                pw->vOut[i]     = new float[meta::phase_detector_metadata::PREWHITEN_BUFFER_SIZE];
+                dsp::fill_zero(pw->vBuffer[i], meta::phase_detector_metadata::PREWHITEN_ORDER);
+            }
+            pw->fLogDecay   = -1.0f / lsp_max(dspu::millis_to_samples(fSampleRate, meta::phase_detector_metadata::PREWHITEN_TIME), 1.0f);
+
+            // Active measurement: the period of the sequence should cover the whole correlation function
+            mls_t *mls      = &sMls;
+            size_t order    = meta::phase_detector_metadata::MLS_ORDER_MIN;
+            while ((((size_t(1) << order) - 1) < (nMaxVectorSize * 2)) && (order < meta::phase_detector_metadata::MLS_ORDER_MAX))
+                ++order;
+            const size_t mls_size = size_t(1) << order;
+            mls->vSignal    = new float[mls_size];
+            mls->vTagS      = new uint32_t[mls_size];
+            mls->vTagL      = new uint32_t[mls_size];
+            mls->vCapture   = new float[mls_size];
+            mls->vTransform = new float[mls_size];
+            mls->vExcitation= new float[meta::phase_detector_metadata::ALIGN_BUFFER_SIZE];
+            mls->nOrder     = 0;
+            mls->nLength    = 0;
+
+            for (size_t i=0; i<2; ++i)
+            {
+                channel_t *c        = &vChannels[i];
+                c->vBuffer          = new float[meta::phase_detector_metadata::ALIGN_BUFFER_SIZE];
+
+                for (size_t j=0; j<2; ++j)
+                {
+                    c->sLine[j].init(nMaxVectorSize + 1);
+                    c->sLine[j].set_delay(0);
+                    c->fGain[j]         = 1.0f;
+                }
+            }
+
+            nAlign          = 0;
+            bAlignInv       = false;
+            nAlignReq       = 0;
+            bAlignReqInv    = false;
+            nAlignHold      = 0;
+            nAlignHoldMax   = dspu::millis_to_samples(fSampleRate, meta::phase_detector_metadata::ALIGN_HOLD_TIME);
+            nActiveLine     = 0;
+            nFadeLen        = lsp_max(size_t(dspu::millis_to_samples(fSampleRate, meta::phase_detector_metadata::ALIGN_FADE_TIME)), 1u);
+            nFadePos        = nFadeLen;
+            nActiveFade     = lsp_min(nActiveFade, nFadeLen);
+
+            nHopSize        = lsp_max(size_t(dspu::millis_to_samples(fSampleRate, fHopTime)), 1u);
+            nHopCounter     = 0;
+
+            nWarmCounter    = 0;
+            nWarmInterval   = lsp_max(size_t(dspu::seconds_to_samples(fSampleRate, meta::phase_detector_metadata::WARM_STATE_INTERVAL)), 1u);
 
             set_time_interval(fTimeInterval, true);
             set_reactive_interval(fReactivity);
+            for (size_t i=0; i<meta::phase_detector_metadata::ACCUMULATORS; ++i)
+                set_accumulator_reactivity(&vAccumulators[i], vAccumulators[i].fReactivity);
 
             clear_buffers();
         }
@@ -320,6 +1138,34 @@ namespace lsp
             bool bypass         = pBypass->value() >= 0.5f;
             bool reset          = pReset->value() >= 0.5f;
             fSelector           = pSelector->value();
+            fHopTime            = pHop->value();
+            nHopSize            = lsp_max(size_t(dspu::millis_to_samples(fSampleRate, fHopTime)), 1u);
+            nHopCounter         = lsp_min(nHopCounter, nHopSize - 1);  // The hop may become shorter than already processed part
+            bAlign              = pAlign->value() >= 0.5f;
+            bPolarity           = pPolarity->value() >= 0.5f;
+            bTelemetry          = pTelemetry->value() >= 0.5f;
+            nTlmInterval        = lsp_max(size_t(dspu::seconds_to_samples(fSampleRate, pTlmInterval->value())), 1u);
+
+            bool spectral       = pSpectral->value() >= 0.5f;
+            if ((spectral) && (!bSpectral))
+                clear_spectrum();
+            bSpectral           = spectral;
+            bool multithread    = pMultithread->value() >= 0.5f;
+            if ((multithread) && (!bMultithread))
+                request_pool();
+            bMultithread        = multithread;
+
+            bool prewhiten      = pPrewhiten->value() >= 0.5f;
+            if (prewhiten != bPrewhiten)
+                clear               = true;
+            bPrewhiten          = prewhiten;
+            bWarmStart          = pWarmStart->value() >= 0.5f;
+            sMls.fLevel         = pActiveLevel->value();
+
+            bool active         = pActive->value() >= 0.5f;
+            if (active != bActive)
+                clear               = true;
+            bActive             = active;
 
             lsp_trace("bypass = %s, reset = %s, selector=%.3f", bypass ? "true" : "false", reset ? "true" : "false", fSelector);
             bBypass             = bypass || reset;
@@ -328,8 +1174,23 @@ namespace lsp
 
             if (set_time_interval(pTime->value(), false))
                 clear = true;
+            if (set_lag_range(pLagMin->value(), pLagMax->value(), false))
+                clear = true;
             set_reactive_interval(pReactivity->value());
 
+            for (size_t i=0; i<meta::phase_detector_metadata::ACCUMULATORS; ++i)
+            {
+                accumulator_t *acc  = &vAccumulators[i];
+                bool enabled        = acc->pEnabled->value() >= 0.5f;
+                if ((enabled) && (!acc->bEnabled))
+                {
+                    dsp::fill_zero(acc->vData, nMaxVectorSize * 2);
+                    acc->fNorm          = 0.0f;
+                }
+                acc->bEnabled       = enabled;
+                set_accumulator_reactivity(acc, acc->pReactivity->value());
+            }
+
             if (clear)
                 clear_buffers();
         }
@@ -348,116 +1209,1149 @@ namespace lsp
             lsp_assert(out_a != NULL);
             lsp_assert(out_b != NULL);
 
-            // Bypass the original signal
-            dsp::copy(out_a, in_a, samples);
-            dsp::copy(out_b, in_b, samples);
+            plug::midi_t *midi  = pMidiOut->buffer<plug::midi_t>();
+            if (midi != NULL)
+                midi->clear();
 
-            if (bBypass)
+            const bool active   = (bActive) && (!bBypass);
+
+            // Resume from the saved state if it matches the current configuration
+            if (bWarmLoad)
+                restore_warm_state();
+            if (sPoolConnector.completed())
             {
-                for (size_t i=0; i<MK_COUNT; ++i)
+                nPoolId             = nPoolPending;
+                sPoolConnector.reset();
+            }
+
+            // Process the block by analysis hops independently of the block size
+            for (size_t offset=0; offset < samples; )
+            {
+                size_t to_do        = (bBypass) ? samples - offset : lsp_min(samples - offset, nHopSize - nHopCounter);
+
+                // The excitation signal is generated while it is audible: in active mode and while
+                // fading out after leaving it. The response is captured before the output is written
+                // because output buffers may be the same to the input ones.
+                const bool excite   = (active) || (nActiveFade > 0);
+                float *exc          = sMls.vExcitation;
+                if (excite)
                 {
-                    meters_t *vm = &vMeters[i];
+                    to_do               = lsp_min(to_do, meta::phase_detector_metadata::ALIGN_BUFFER_SIZE);
+                    process_active(exc, &in_b[offset], to_do, active);
+                }
 
-                    vm->pTime       -> set_value(0.0f);
-                    vm->pSamples    -> set_value(0.0f);
-                    vm->pDistance   -> set_value(0.0f);
+                if (!bBypass)
+                {
+                    if (!active)
+                        analyze(&in_a[offset], &in_b[offset], to_do);
+
+                    // Post-process the function once per each hop
+                    nHopCounter        += to_do;
+                    if (nHopCounter >= nHopSize)
+                    {
+                        nHopCounter         = 0;
+                        update_results();
+                        emit_delay_event(midi, offset + to_do - 1);
+                    }
+                }
+
+                if ((active) && (nActiveFade >= nFadeLen))
+                {
+                    // The excitation signal replaces the output signal. Delay lines still receive
+                    // the input signal, so they do not contain stale data after leaving active mode
+                    feed_alignment(&in_a[offset], 0, to_do);
+                    feed_alignment(&in_b[offset], 1, to_do);
+                    dsp::copy(&out_a[offset], exc, to_do);
+                    dsp::copy(&out_b[offset], exc, to_do);
+                }
+                else
+                {
+                    // Output the (possibly aligned) signal
+                    if (!active)
+                        update_alignment(to_do);
+                    process_alignment(&out_a[offset], &in_a[offset], 0, to_do);
+                    process_alignment(&out_b[offset], &in_b[offset], 1, to_do);
+                    if (nFadePos < nFadeLen)
+                    {
+                        nFadePos            = lsp_min(nFadePos + to_do, nFadeLen);
+                        if (nFadePos >= nFadeLen)
+                            nActiveLine        ^= 1;
+                    }
+
+                    // Crossfade with the excitation signal when entering or leaving active mode
+                    if (excite)
+                        fade_excitation(&out_a[offset], &out_b[offset], exc, to_do, active);
+                }
+
+                offset             += to_do;
+            }
+
+            if (bBypass)
+            {
+                for (size_t i=0; i<MK_COUNT; ++i)
+                {
+                    meters_t *vm = &vMeters[i];
+
+                    vm->pTime       -> set_value(0.0f);
+                    vm->pSamples    -> set_value(0.0f);
+                    vm->pDistance   -> set_value(0.0f);
                     vm->pValue      -> set_value(0.0f);
                 }
 
                 if ((mesh != NULL) && (mesh->isEmpty()))
                     mesh->data(2, 0);       // Set mesh to empty data
+            }
+            else
+                output_meters(mesh);
+
+            output_accumulators();
+            output_spectrum();
+
+            pAlignTime->set_value(dspu::samples_to_millis(fSampleRate, nAlign));
 
-                // Always query drawing
+            // Report the telemetry
+            update_telemetry(samples);
+            update_warm_state(samples);
+
+            // Always query drawing
+            if (pWrapper != NULL)
                 pWrapper->query_display_draw();
+        }
+
+        void phase_detector::analyze(const float *in_a, const float *in_b, size_t samples)
+        {
+            // Perform spectral analysis
+            if (bSpectral)
+                process_spectrum(in_a, in_b, samples);
+
+            if (!bPrewhiten)
+            {
+                correlate(in_a, in_b, samples);
                 return;
             }
 
-            // Make calculations
+            // Correlate the whitened signal
+            const prewhiten_t *pw   = &sPrewhiten;
             while (samples > 0)
             {
-                ssize_t filled   = fill_gap(in_a, in_b, samples);
-                samples -= filled;
+                const size_t to_do  = lsp_min(samples, meta::phase_detector_metadata::PREWHITEN_BUFFER_SIZE);
+                prewhiten(in_a, in_b, to_do);
+                correlate(pw->vOut[0], pw->vOut[1], to_do);
 
-                // Subtract values
-                while (nGapOffset < nGapSize)
-                {
-                    // Make assertions
-                    lsp_assert((nGapOffset + nFuncSize) <= (nMaxVectorSize * 4));
-                    lsp_assert(nGapOffset <= (nMaxVectorSize * 3));
-                    lsp_assert((nGapOffset + nVectorSize + nFuncSize) < (nMaxVectorSize * 4));
-                    lsp_assert((nGapOffset + nVectorSize) <= (nMaxVectorSize * 3));
+                in_a               += to_do;
+                in_b               += to_do;
+                samples            -= to_do;
+            }
+        }
+
+        void phase_detector::prewhiten(const float *a, const float *b, size_t samples)
+        {
+            /*
+             * Both inputs are passed through the same inverse filter of linear prediction
+             * computed for the averaged spectrum of both inputs. The filter flattens the spectrum
+             * and makes the correlation peak sharp while keeping the delay between inputs.
+             */
+            prewhiten_t *pw         = &sPrewhiten;
+            constexpr size_t order  = meta::phase_detector_metadata::PREWHITEN_ORDER;
+            float corr[order + 1];
+
+            // Append new data to the history
+            dsp::copy(&pw->vBuffer[0][order], a, samples);
+            dsp::copy(&pw->vBuffer[1][order], b, samples);
+
+            // Update the averaged autocorrelation of inputs
+            const float decay       = expf(pw->fLogDecay * samples);
+            for (size_t k=0; k<=order; ++k)
+            {
+                corr[k]                 =
+                    dsp::scalar_mul(&pw->vBuffer[0][order], &pw->vBuffer[0][order - k], samples) +
+                    dsp::scalar_mul(&pw->vBuffer[1][order], &pw->vBuffer[1][order - k], samples);
+                pw->vCorr[k]            = pw->vCorr[k] * decay + corr[k];
+            }
 
-                    // Update function peak values
-                    // vFunction[i] = vFunction[i] - vB.pData[i + nGapOffset] * vA.pData[nGapOffset] +
-                    //                + vB.pData[i + nGapOffset + nVectorSize] * vA.pData[nGapOffset + nVectorSize]
-                    dsp::mix_add2(vFunction,
-                            &vB.pData[nGapOffset], &vB.pData[nGapOffset + nVectorSize],
-                            -vA.pData[nGapOffset], vA.pData[nGapOffset + nVectorSize],
-                            nFuncSize);
+            // Compute the inverse filter, add the white noise correction for stability
+            dsp::copy(corr, pw->vCorr, order + 1);
+            corr[0]                *= 1.0001f;
+            levinson_durbin(pw->vCoeffs, corr, order);
 
+            // Apply the filter: y[n] = x[n] + sum(a[k] * x[n-k]) for k=1..order
+            for (size_t i=0; i<2; ++i)
+            {
+                float *buf              = pw->vBuffer[i];
+                float *out              = pw->vOut[i];
 
-                    // Accumulate peak function value
-                    // vAccumulated[i] = vAccumulated[i] * (1.0f - fTau) + vFunction * fTau
-                    dsp::mix2(vAccumulated, vFunction, 1.0f - fTau, fTau, nFuncSize);
+                dsp::copy(out, &buf[order], samples);
+                for (size_t k=1; k<=order; ++k)
+                    dsp::fmadd_k3(out, &buf[order - k], pw->vCoeffs[k], samples);
 
-                    // Increment gap offset: move to next sample
-                    nGapOffset++;
-                }
+                // Keep the history for the next call
+                dsp::move(buf, &buf[samples], order);
+            }
+        }
+
+        void phase_detector::levinson_durbin(float *a, const float *r, size_t order)
+        {
+            constexpr size_t max_order  = meta::phase_detector_metadata::PREWHITEN_ORDER;
+            float tmp[max_order + 1];
+
+            a[0]                = 1.0f;
+            for (size_t i=1; i<=order; ++i)
+                a[i]                = 0.0f;
+
+            float err           = r[0];
+            if (err <= 0.0f)
+                return;
+
+            for (size_t i=1; i<=order; ++i)
+            {
+                // Compute the reflection coefficient
+                float acc           = r[i];
+                for (size_t j=1; j<i; ++j)
+                    acc                += a[j] * r[i - j];
+                const float k       = -acc / err;
+
+                // Update coefficients
+                for (size_t j=1; j<i; ++j)
+                    tmp[j]              = a[j] + k * a[i - j];
+                for (size_t j=1; j<i; ++j)
+                    a[j]                = tmp[j];
+                a[i]                = k;
+
+                err                *= 1.0f - k * k;
+                if (err <= 0.0f)
+                    break;
             }
+        }
 
+        void phase_detector::correlate(const float *a, const float *b, size_t samples)
+        {
+            while (samples > 0)
+            {
+                size_t filled   = fill_gap(a, b, samples);
+                a              += filled;
+                b              += filled;
+                samples        -= filled;
+
+                if (nGapOffset >= nGapSize)
+                    continue;
+
+                // Update the function for all new samples in the gap. Elements of the function
+                // are independent, so the range of lags can be split between worker threads
+                if ((bMultithread) && (nJobChunks > 1) && (nJobChunks <= nChunks))
+                    analysis_pool::execute(nPoolId, &sCorrJob, nJobChunks);
+                else
+                    update_function(nFuncFirst, nFuncCount);
+                nGapOffset      = nGapSize;
+            }
+        }
+
+        void phase_detector::update_results()
+        {
             // Now analyze average function in the time
-            size_t best     = nVectorSize, worst = nVectorSize;
+            find_extremums();
+
             ssize_t sel     = nFuncSize * (1.0 - (fSelector + meta::phase_detector_metadata::SELECTOR_MAX) /
                               (meta::phase_detector_metadata::SELECTOR_MAX - meta::phase_detector_metadata::SELECTOR_MIN));
-            if (sel >= ssize_t(nFuncSize))
-                sel             = nFuncSize - 1;
-            else if (sel < 0)
-                sel             = 0;
+            sel             = lsp_limit(sel, ssize_t(nFuncFirst), ssize_t(nFuncFirst + nFuncCount) - 1);
+
+            nSelected           = ssize_t(nVectorSize - sel);
+            fSelectedValue      = vNormalized[sel];
+
+            // Find best and worst positions of additional accumulators
+            for (size_t i=0; i<meta::phase_detector_metadata::ACCUMULATORS; ++i)
+            {
+                accumulator_t *acc  = &vAccumulators[i];
+                if (!acc->bEnabled)
+                    continue;
+
+                const float *f      = &acc->vData[nFuncFirst];
+                const size_t best   = dsp::max_index(f, nFuncCount);
+                const size_t worst  = dsp::min_index(f, nFuncCount);
+                const float amax    = lsp_max(f[best], -f[worst]);
+
+                acc->fNorm          = (amax > 0.0f) ? 1.0f / amax : 0.0f;
+                acc->nBest          = ssize_t(nVectorSize - nFuncFirst - best);
+                acc->nWorst         = ssize_t(nVectorSize - nFuncFirst - worst);
+                acc->fBestValue     = f[best] * acc->fNorm;
+                acc->fWorstValue    = f[worst] * acc->fNorm;
+            }
+        }
+
+        void phase_detector::emit_delay_event(plug::midi_t *midi, size_t timestamp)
+        {
+            if ((midi == NULL) || ((bEventValid) && (nEventBest == nBest)))
+                return;
 
-            dsp::normalize(vNormalized, vAccumulated, nFuncSize);
-            dsp::minmax_index(vNormalized, nFuncSize, &worst, &best);
+            nEventBest          = nBest;
+            bEventValid         = true;
+
+            // Map the best time to the 14-bit controller value
+            const float time    = dspu::samples_to_millis(fSampleRate, nBest);
+            const float k       = (time - meta::phase_detector_metadata::TIME_MIN) /
+                                  (meta::phase_detector_metadata::TIME_MAX - meta::phase_detector_metadata::TIME_MIN);
+            const uint32_t value= lsp_limit(int32_t(k * 0x3fff + 0.5f), 0, 0x3fff);
+
+            midi::event_t ev;
+            ev.timestamp        = timestamp;
+            ev.type             = midi::MIDI_MSG_NOTE_CONTROLLER;
+            ev.channel          = 0;
+            ev.ctl.control      = meta::phase_detector_metadata::MIDI_CC_DELAY_MSB;
+            ev.ctl.value        = (value >> 7) & 0x7f;
+            midi->push(ev);
+
+            ev.ctl.control      = meta::phase_detector_metadata::MIDI_CC_DELAY_LSB;
+            ev.ctl.value        = value & 0x7f;
+            midi->push(ev);
+        }
+
+        void phase_detector::init_chunk(corr_chunk_t *c, size_t first, size_t count)
+        {
+            c->nFirst           = first;
+            c->nCount           = count;
+            c->nGapOffset       = nGapOffset;
+            c->nGapSize         = nGapSize;
+            c->nVectorSize      = nVectorSize;
+            c->fTau             = fTau;
+            for (size_t i=0; i<meta::phase_detector_metadata::ACCUMULATORS; ++i)
+            {
+                const accumulator_t *acc = &vAccumulators[i];
+                c->vTau[i]          = acc->fTau;
+                c->vEnabled[i]      = acc->bEnabled;
+            }
+        }
+
+        void phase_detector::update_function(size_t first, size_t count)
+        {
+            // Update the shared function and accumulators in place
+            corr_chunk_t c;
+            float *accs[meta::phase_detector_metadata::ACCUMULATORS];
+
+            init_chunk(&c, first, count);
+            for (size_t i=0; i<meta::phase_detector_metadata::ACCUMULATORS; ++i)
+                accs[i]             = &vAccumulators[i].vData[first];
+
+            update_range(&c, &vFunction[first], &vAccumulated[first], accs);
+        }
+
+        void phase_detector::compute_chunk(corr_chunk_t *c)
+        {
+            // Worker thread: compute the private copy of the chunk, shared data is updated on commit
+            dsp::copy(c->vFunction, &vFunction[c->nFirst], c->nCount);
+            dsp::copy(c->vAccumulated, &vAccumulated[c->nFirst], c->nCount);
+            for (size_t i=0; i<meta::phase_detector_metadata::ACCUMULATORS; ++i)
+            {
+                if (c->vEnabled[i])
+                    dsp::copy(c->vAccumulators[i], &vAccumulators[i].vData[c->nFirst], c->nCount);
+            }
+
+            update_range(c, c->vFunction, c->vAccumulated, c->vAccumulators);
+        }
+
+        void phase_detector::commit_chunk(const corr_chunk_t *c)
+        {
+            dsp::copy(&vFunction[c->nFirst], c->vFunction, c->nCount);
+            dsp::copy(&vAccumulated[c->nFirst], c->vAccumulated, c->nCount);
+            for (size_t i=0; i<meta::phase_detector_metadata::ACCUMULATORS; ++i)
+            {
+                if (c->vEnabled[i])
+                    dsp::copy(&vAccumulators[i].vData[c->nFirst], c->vAccumulators[i], c->nCount);
+            }
+        }
+
+        void phase_detector::update_range(const corr_chunk_t *c, float *func, float *accum, float * const *accs)
+        {
+            /*
+             * Process the range of lags by small tiles. The tile of the function and accumulators
+             * and the sliding windows of B data stay in the L1 cache while all samples of the gap
+             * are processed, so the memory traffic does not depend on the analysis time.
+             * Each element of the function is still updated sample by sample in the same order,
+             * so the result does not differ from the non-tiled computation.
+             */
+            for (size_t index=0; index < c->nCount; )
+            {
+                const size_t to_do  = lsp_min(c->nCount - index, meta::phase_detector_metadata::CACHE_TILE_SIZE);
+                update_tile(c, func, accum, accs, index, to_do);
+                index              += to_do;
+            }
+        }
+
+        void phase_detector::update_tile(const corr_chunk_t *c, float *func, float *accum, float * const *accs, size_t index, size_t count)
+        {
+            // Destination buffers start with the first lag of the chunk
+            const size_t first  = c->nFirst + index;
+            const size_t vsize  = c->nVectorSize;
+
+            for (size_t offset = c->nGapOffset; offset < c->nGapSize; ++offset)
+            {
+                // Make assertions
+                lsp_assert(offset <= (nMaxVectorSize * 3));
+                lsp_assert((offset + vsize + first + count) <= (nMaxVectorSize * 4));
+                lsp_assert((offset + vsize) <= (nMaxVectorSize * 3));
+
+                // Update function peak values
+                // vFunction[i] = vFunction[i] - vB.pData[i + offset] * vA.pData[offset] +
+                //                + vB.pData[i + offset + nVectorSize] * vA.pData[offset + nVectorSize]
+                // Only the range of [first, first + count) is computed
+                dsp::mix_add2(&func[index],
+                        &vB.pData[offset + first], &vB.pData[offset + vsize + first],
+                        -vA.pData[offset], vA.pData[offset + vsize],
+                        count);
+
+                // Accumulate peak function value
+                // vAccumulated[i] = vAccumulated[i] * (1.0f - fTau) + vFunction * fTau
+                dsp::mix2(&accum[index], &func[index], 1.0f - c->fTau, c->fTau, count);
+
+                // Additional accumulators take the same function while it is still in the cache
+                for (size_t i=0; i<meta::phase_detector_metadata::ACCUMULATORS; ++i)
+                {
+                    if (c->vEnabled[i])
+                        dsp::mix2(&accs[i][index], &func[index], 1.0f - c->vTau[i], c->vTau[i], count);
+                }
+            }
+        }
+
+        void phase_detector::generate_mls()
+        {
+            mls_t *mls      = &sMls;
+            if (mls->vSignal == NULL)
+                return;
+
+            // The period of the sequence should cover the whole correlation function
+            size_t order    = meta::phase_detector_metadata::MLS_ORDER_MIN;
+            while ((((size_t(1) << order) - 1) < nFuncSize) && (order < meta::phase_detector_metadata::MLS_ORDER_MAX))
+                ++order;
+            if (order == mls->nOrder)
+                return;
+
+            const size_t length = (size_t(1) << order) - 1;
+            lsp_debug("MLS order = %d, length = %d", int(order), int(length));
+            mls->nOrder     = order;
+            mls->nLength    = length;
+            mls->nPosition  = 0;
+            mls->nPeriods   = 0;
+
+            // Generate the sequence with the Fibonacci LFSR. The bit i of the register holds
+            // the (k+i)-th bit of the sequence, so the state of the register at the position k
+            // is also the index of the k-th captured sample before the Hadamard transform
+            uint32_t mask   = 0;
+            for (const uint8_t *t = mls_taps[order - meta::phase_detector_metadata::MLS_ORDER_MIN]; *t != 0; ++t)
+                mask           |= uint32_t(1) << (order - *t);
+
+            size_t pos[meta::phase_detector_metadata::MLS_ORDER_MAX];
+            uint32_t state  = 1;
+            for (size_t k=0; k<length; ++k)
+            {
+                mls->vSignal[k] = (state & 1) ? -1.0f : 1.0f;
+                mls->vTagS[k]   = state;
+                if ((state & (state - 1)) == 0)
+                    pos[int_log2(state)]    = k;
+
+                uint32_t fb     = state & mask;
+                fb             ^= fb >> 16;
+                fb             ^= fb >> 8;
+                fb             ^= fb >> 4;
+                fb             ^= fb >> 2;
+                fb             ^= fb >> 1;
+                state           = (state >> 1) | ((fb & 1) << (order - 1));
+            }
+
+            // Compute the index of each element of the correlation function after the Hadamard transform:
+            // the bit i of the index for the lag j is the (pos[i] - j)-th bit of the sequence
+            for (size_t j=0; j<length; ++j)
+            {
+                uint32_t tag    = 0;
+                for (size_t i=0; i<order; ++i)
+                {
+                    size_t idx      = pos[i] + length - j;
+                    if (idx >= length)
+                        idx            -= length;
+                    if (mls->vSignal[idx] < 0.0f)
+                        tag            |= uint32_t(1) << i;
+                }
+                mls->vTagL[j]   = tag;
+            }
+        }
+
+        void phase_detector::process_active(float *dst, const float *in_b, size_t samples, bool measure)
+        {
+            mls_t *mls      = &sMls;
+
+            while (samples > 0)
+            {
+                const size_t to_do  = lsp_min(samples, mls->nLength - mls->nPosition);
+
+                // Generate the excitation and capture the response to it
+                dsp::mul_k3(dst, &mls->vSignal[mls->nPosition], mls->fLevel, to_do);
+                if (measure)
+                {
+                    dsp::copy(&mls->vCapture[mls->nPosition], in_b, to_do);
+                    if (bSpectral)
+                        process_spectrum(dst, in_b, to_do);
+                }
+
+                mls->nPosition += to_do;
+                dst            += to_do;
+                in_b           += to_do;
+                samples        -= to_do;
+
+                // The response to the first period is not periodic yet, skip it
+                if (mls->nPosition >= mls->nLength)
+                {
+                    if ((measure) && (mls->nPeriods > 0))
+                        analyze_mls();
+                    mls->nPosition      = 0;
+                    ++mls->nPeriods;
+                }
+            }
+        }
+
+        void phase_detector::fade_excitation(float *out_a, float *out_b, const float *src, size_t samples, bool active)
+        {
+            const float k       = 1.0f / nFadeLen;
+            size_t fade         = nActiveFade;
+
+            for (size_t i=0; i<samples; ++i)
+            {
+                const float mix     = fade * k;
+                out_a[i]           += (src[i] - out_a[i]) * mix;
+                out_b[i]           += (src[i] - out_b[i]) * mix;
+
+                if (active)
+                    fade                = lsp_min(fade + 1, nFadeLen);
+                else if (fade > 0)
+                    --fade;
+            }
+
+            nActiveFade         = fade;
+        }
+
+        void phase_detector::analyze_mls()
+        {
+            mls_t *mls          = &sMls;
+            float *v            = mls->vTransform;
+            const size_t length = mls->nLength;
+
+            // Permute the captured response and perform the Hadamard transform, the result is
+            // the circular cross-correlation of the sequence and the response:
+            //   r[j] = sum(s[k] * y[(k + j) % L]) for k=0..L-1
+            v[0]                = 0.0f;
+            for (size_t k=0; k<length; ++k)
+                v[mls->vTagS[k]]    = mls->vCapture[k];
+            hadamard_transform(v, length + 1);
+
+            // The lag for index i of the correlation function is (nVectorSize - i), so f[i] = r[(i - nVectorSize) % L]
+            const float norm    = 1.0f / (length + 1);
+            for (size_t i=nFuncFirst, n=nFuncFirst + nFuncCount; i<n; ++i)
+            {
+                size_t j            = i + length - nVectorSize;
+                if (j >= length)
+                    j                  -= length;
+                vFunction[i]        = v[mls->vTagL[j]] * norm;
+            }
+
+            // Accumulate peak function value
+            dsp::mix2(&vAccumulated[nFuncFirst], &vFunction[nFuncFirst], 1.0f - mls->fTau, mls->fTau, nFuncCount);
+            for (size_t i=0; i<meta::phase_detector_metadata::ACCUMULATORS; ++i)
+            {
+                accumulator_t *acc  = &vAccumulators[i];
+                if (acc->bEnabled)
+                    dsp::mix2(&acc->vData[nFuncFirst], &vFunction[nFuncFirst], 1.0f - acc->fPeriodTau, acc->fPeriodTau, nFuncCount);
+            }
+        }
+
+        void phase_detector::hadamard_transform(float *v, size_t count)
+        {
+            for (size_t h=1; h<count; h <<= 1)
+            {
+                for (size_t i=0; i<count; i += (h << 1))
+                {
+                    for (size_t j=i, n=i+h; j<n; ++j)
+                    {
+                        const float a   = v[j];
+                        const float b   = v[j + h];
+                        v[j]            = a + b;
+                        v[j + h]        = a - b;
+                    }
+                }
+            }
+        }
+
+        void phase_detector::insert_extremum(extremum_t *list, size_t *count, size_t index, float value)
+        {
+            // The list is sorted in descending order of values
+            size_t n        = *count;
+            if (n >= meta::phase_detector_metadata::PEAKS_MAX)
+            {
+                if (value <= list[n-1].fValue)
+                    return;
+                --n;
+            }
+
+            size_t i        = n;
+            for ( ; (i > 0) && (list[i-1].fValue < value); --i)
+                list[i]         = list[i-1];
+
+            list[i].nIndex  = index;
+            list[i].fValue  = value;
+            *count          = n + 1;
+        }
+
+        void phase_detector::find_extremums()
+        {
+            /*
+             * Normalize the computed part of the accumulated function and find the best and the worst
+             * positions with vectorized kernels. The scalar scan only collects the highest local maximums
+             * and the lowest local minimums: a sample is checked for being the local extremum only when it
+             * can get to the list, so the list is rarely updated.
+             */
+            const float *f      = vNormalized;
+            const size_t first  = nFuncFirst;
+            const size_t last   = nFuncFirst + nFuncCount;
+            size_t best         = 0, worst = 0;
+
+            dsp::normalize(&vNormalized[first], &vAccumulated[first], nFuncCount);
+            dsp::minmax_index(&vNormalized[first], nFuncCount, &worst, &best);
+            best               += first;
+            worst              += first;
+
+            // Normalized values are within [-1, 1], so initial thresholds pass any extremum
+            size_t peaks        = 0, dips = 0;
+            float pmin          = -2.0f, dmin = -2.0f;
+
+            for (size_t i=first + 1; i + 1 < last; ++i)
+            {
+                const float curr    = f[i];
+                if ((curr > pmin) && (curr > f[i-1]) && (curr >= f[i+1]))
+                {
+                    insert_extremum(vPeaks, &peaks, i, curr);
+                    if (peaks >= meta::phase_detector_metadata::PEAKS_MAX)
+                        pmin                = vPeaks[peaks - 1].fValue;
+                }
+                else if ((-curr > dmin) && (curr < f[i-1]) && (curr <= f[i+1]))
+                {
+                    insert_extremum(vDips, &dips, i, -curr);
+                    if (dips >= meta::phase_detector_metadata::PEAKS_MAX)
+                        dmin                = vDips[dips - 1].fValue;
+                }
+            }
+
+            // Remove the best and the worst positions from the list of secondary extremums
+            nPeaks              = 0;
+            for (size_t i=0; i<peaks; ++i)
+                if ((vPeaks[i].nIndex != best) && (nPeaks < (meta::phase_detector_metadata::PEAKS_MAX - 1)))
+                    vPeaks[nPeaks++]    = vPeaks[i];
+            nDips               = 0;
+            for (size_t i=0; i<dips; ++i)
+                if ((vDips[i].nIndex != worst) && (nDips < (meta::phase_detector_metadata::PEAKS_MAX - 1)))
+                    vDips[nDips++]      = vDips[i];
 
-            // Output values
             nBest               = ssize_t(nVectorSize - best);
-            nSelected           = ssize_t(nVectorSize - sel);
             nWorst              = ssize_t(nVectorSize - worst);
+            fBestValue          = f[best];
+            fWorstValue         = f[worst];
+
+            // Dips have been collected by magnitude, restore their sign
+            for (size_t i=0; i<nDips; ++i)
+                vDips[i].fValue     = -vDips[i].fValue;
+
+            // The confidence is the peak-to-sidelobe level: how much the best peak is higher than the next one
+            if (fBestValue <= 0.0f)
+                fConfidence         = 0.0f;
+            else if (nPeaks <= 0)
+                fConfidence         = 1.0f;
+            else
+                fConfidence         = lsp_limit(1.0f - lsp_max(vPeaks[0].fValue, 0.0f) / fBestValue, 0.0f, 1.0f);
+        }
 
+        void phase_detector::output_meters(plug::mesh_t *mesh)
+        {
             vMeters[MK_BEST].pTime      -> set_value(dspu::samples_to_millis(fSampleRate, nBest));
             vMeters[MK_BEST].pSamples   -> set_value(nBest);
             vMeters[MK_BEST].pDistance  -> set_value(dspu::samples_to_centimeters(fSampleRate, LSP_DSP_UNITS_SOUND_SPEED_M_S, nBest));
-            vMeters[MK_BEST].pValue     -> set_value(vNormalized[best]);
+            vMeters[MK_BEST].pValue     -> set_value(fBestValue);
 
             vMeters[MK_SEL].pTime       -> set_value(dspu::samples_to_millis(fSampleRate, nSelected));
             vMeters[MK_SEL].pSamples    -> set_value(nSelected);
             vMeters[MK_SEL].pDistance   -> set_value(dspu::samples_to_centimeters(fSampleRate, LSP_DSP_UNITS_SOUND_SPEED_M_S, nSelected));
-            vMeters[MK_SEL].pValue      -> set_value(vNormalized[sel]);
+            vMeters[MK_SEL].pValue      -> set_value(fSelectedValue);
 
             vMeters[MK_WORST].pTime     -> set_value(dspu::samples_to_millis(fSampleRate, nWorst));
             vMeters[MK_WORST].pSamples  -> set_value(nWorst);
             vMeters[MK_WORST].pDistance -> set_value(dspu::samples_to_centimeters(fSampleRate, LSP_DSP_UNITS_SOUND_SPEED_M_S, nWorst));
-            vMeters[MK_WORST].pValue    -> set_value(vNormalized[worst]);
+            vMeters[MK_WORST].pValue    -> set_value(fWorstValue);
+
+            pConfidence->set_value(fConfidence);
+            pNumPeaks->set_value(nPeaks);
+            pNumDips->set_value(nDips);
+            for (size_t i=0; i<meta::phase_detector_metadata::PEAKS_MAX - 1; ++i)
+            {
+                extremum_meters_t *em   = &vExtMeters[i];
+                if (i < nPeaks)
+                {
+                    em->pPeakTime   -> set_value(dspu::samples_to_millis(fSampleRate, ssize_t(nVectorSize - vPeaks[i].nIndex)));
+                    em->pPeakValue  -> set_value(vPeaks[i].fValue);
+                }
+                else
+                {
+                    em->pPeakTime   -> set_value(0.0f);
+                    em->pPeakValue  -> set_value(0.0f);
+                }
+                if (i < nDips)
+                {
+                    em->pDipTime    -> set_value(dspu::samples_to_millis(fSampleRate, ssize_t(nVectorSize - vDips[i].nIndex)));
+                    em->pDipValue   -> set_value(vDips[i].fValue);
+                }
+                else
+                {
+                    em->pDipTime    -> set_value(0.0f);
+                    em->pDipValue   -> set_value(0.0f);
+                }
+            }
 
             // Output mesh if specified
-            if ((mesh != NULL) && (mesh->isEmpty()))
+            output_function(mesh, vNormalized, 1.0f);
+        }
+
+        void phase_detector::output_function(plug::mesh_t *mesh, const float *f, float norm)
+        {
+            if ((mesh == NULL) || (!mesh->isEmpty()))
+                return;
+
+            float *x    = mesh->pvData[0];
+            float *y    = mesh->pvData[1];
+            float di    = (nFuncCount - 1.0) / (meta::phase_detector_metadata::MESH_POINTS - 1);
+
+            for (size_t i=0; i<meta::phase_detector_metadata::MESH_POINTS; ++i)
             {
-                float *x    = mesh->pvData[0];
-                float *y    = mesh->pvData[1];
-                float di    = (nFuncSize - 1.0) / meta::phase_detector_metadata::MESH_POINTS;
-                float dx    = dspu::samples_to_millis(fSampleRate, di);
-                ssize_t ci  = ssize_t(meta::phase_detector_metadata::MESH_POINTS >> 1);
+                size_t idx  = nFuncFirst + size_t(i * di);
+                *(x++)      = dspu::samples_to_millis(fSampleRate, ssize_t(nVectorSize) - ssize_t(idx));
+                *(y++)      = f[idx] * norm;
+            }
 
-                for (size_t i=0; i<meta::phase_detector_metadata::MESH_POINTS; ++i)
+            mesh->data(2, meta::phase_detector_metadata::MESH_POINTS);
+        }
+
+        void phase_detector::output_accumulators()
+        {
+            for (size_t i=0; i<meta::phase_detector_metadata::ACCUMULATORS; ++i)
+            {
+                accumulator_t *acc  = &vAccumulators[i];
+                plug::mesh_t *mesh  = acc->pFunction->buffer<plug::mesh_t>();
+
+                if ((bBypass) || (!acc->bEnabled))
                 {
-                    *(x++)      = dx * (ci - ssize_t(i));
-                    *(y++)      = vNormalized[size_t(i * di)];
+                    acc->pBestTime      -> set_value(0.0f);
+                    acc->pBestValue     -> set_value(0.0f);
+                    acc->pWorstTime     -> set_value(0.0f);
+                    acc->pWorstValue    -> set_value(0.0f);
+
+                    if ((mesh != NULL) && (mesh->isEmpty()))
+                        mesh->data(2, 0);       // Set mesh to empty data
+                    continue;
                 }
 
-                mesh->data(2, meta::phase_detector_metadata::MESH_POINTS);
+                acc->pBestTime      -> set_value(dspu::samples_to_millis(fSampleRate, acc->nBest));
+                acc->pBestValue     -> set_value(acc->fBestValue);
+                acc->pWorstTime     -> set_value(dspu::samples_to_millis(fSampleRate, acc->nWorst));
+                acc->pWorstValue    -> set_value(acc->fWorstValue);
+
+                output_function(mesh, acc->vData, acc->fNorm);
             }
+        }
 
-            // Always query drawing
-            if (pWrapper != NULL)
-                pWrapper->query_display_draw();
+        void phase_detector::process_spectrum(const float *a, const float *b, size_t samples)
+        {
+            spectrum_t *sp      = &sSpectrum;
+            const size_t hop    = sp->nSize >> 1;
+
+            while (samples > 0)
+            {
+                size_t to_do        = lsp_min(sp->nSize - sp->nFill, samples);
+                dsp::copy(&sp->vFrame[0][sp->nFill], a, to_do);
+                dsp::copy(&sp->vFrame[1][sp->nFill], b, to_do);
+                sp->nFill          += to_do;
+                a                  += to_do;
+                b                  += to_do;
+                samples            -= to_do;
+
+                // Analyze the frame and shift the data by the hop size
+                if (sp->nFill >= sp->nSize)
+                {
+                    analyze_frame();
+
+                    dsp::move(sp->vFrame[0], &sp->vFrame[0][hop], sp->nSize - hop);
+                    dsp::move(sp->vFrame[1], &sp->vFrame[1][hop], sp->nSize - hop);
+                    sp->nFill          -= hop;
+                }
+            }
+        }
+
+        void phase_detector::analyze_frame()
+        {
+            spectrum_t *sp      = &sSpectrum;
+            const size_t bins   = (sp->nSize >> 1) + 1;
+            const float k       = sp->fTau;
+            const float rk      = 1.0f - k;
+
+            // Compute spectrum of both frames
+            for (size_t i=0; i<2; ++i)
+            {
+                dsp::mul3(sp->vTemp, sp->vFrame[i], sp->vWindow, sp->nSize);
+                dsp::pcomplex_r2c(sp->vFft[i], sp->vTemp, sp->nSize);
+                dsp::packed_direct_fft(sp->vFft[i], sp->vFft[i], sp->nRank);
+            }
+
+            // Accumulate cross-spectrum and power spectrums
+            // vCross[i]    = vCross[i] * (1 - k) + A[i] * conj(B[i]) * k
+            // vPower[j][i] = vPower[j][i] * (1 - k) + |X[j][i]|^2 * k
+            const float *fa     = sp->vFft[0];
+            const float *fb     = sp->vFft[1];
+            float *c            = sp->vCross;
+            float *pa           = sp->vPower[0];
+            float *pb           = sp->vPower[1];
+
+            for (size_t i=0; i<bins; ++i, fa += 2, fb += 2, c += 2)
+            {
+                const float ar      = fa[0], ai = fa[1];
+                const float br      = fb[0], bi = fb[1];
+
+                c[0]                = c[0] * rk + (ar*br + ai*bi) * k;
+                c[1]                = c[1] * rk + (ai*br - ar*bi) * k;
+                pa[i]               = pa[i] * rk + (ar*ar + ai*ai) * k;
+                pb[i]               = pb[i] * rk + (br*br + bi*bi) * k;
+            }
+        }
+
+        void phase_detector::output_spectrum()
+        {
+            plug::mesh_t *msc   = pCoherence->buffer<plug::mesh_t>();
+            plug::mesh_t *gd    = pGroupDelay->buffer<plug::mesh_t>();
+            if ((msc != NULL) && (!msc->isEmpty()))
+                msc                 = NULL;
+            if ((gd != NULL) && (!gd->isEmpty()))
+                gd                  = NULL;
+            if ((msc == NULL) && (gd == NULL))
+                return;
+
+            // Output empty meshes if analysis is not active
+            if ((bBypass) || (!bSpectral))
+            {
+                if (msc != NULL)
+                    msc->data(2, 0);
+                if (gd != NULL)
+                    gd->data(2, 0);
+                return;
+            }
+
+            /*
+             * Compute values for each logarithmic band:
+             *   - coherence is the average of magnitude-squared coherence of all bins in the band:
+             *     msc[i] = |Sab[i]|^2 / (Saa[i] * Sbb[i])
+             *   - group delay is estimated from the average phase difference between adjacent bins:
+             *     gd = - arg(sum(Sab[i+1] * conj(Sab[i]))) / dw
+             */
+            const spectrum_t *sp    = &sSpectrum;
+            const size_t points     = meta::phase_detector_metadata::SPECTRUM_POINTS;
+            const size_t last       = sp->nSize >> 1;
+            const float fmin        = meta::phase_detector_metadata::SPECTRUM_FREQ_MIN;
+            const float fmax        = lsp_min(meta::phase_detector_metadata::SPECTRUM_FREQ_MAX, fSampleRate * 0.5f);
+            const float kf          = float(sp->nSize) / fSampleRate;
+            const float kd          = logf(fmax / fmin) / points;
+            const float kt          = -1000.0f * sp->nSize / (2.0f * M_PI * fSampleRate);
+
+            for (size_t i=0; i<points; ++i)
+            {
+                const size_t k0     = lsp_min(size_t(fmin * expf(kd * i) * kf), last - 1);
+                const size_t k1     = lsp_limit(size_t(fmin * expf(kd * (i + 1)) * kf), k0 + 1, last);
+
+                float coh           = 0.0f;
+                size_t count        = 0;
+                float dr            = 0.0f, di = 0.0f;
+
+                for (size_t j=k0; j<k1; ++j)
+                {
+                    const float *c      = &sp->vCross[j * 2];
+                    const float den     = sp->vPower[0][j] * sp->vPower[1][j];
+                    if (den > 0.0f)
+                    {
+                        coh                += (c[0]*c[0] + c[1]*c[1]) / den;
+                        ++count;
+                    }
+
+                    // Sab[j+1] * conj(Sab[j])
+                    dr                 += c[2]*c[0] + c[3]*c[1];
+                    di                 += c[3]*c[0] - c[2]*c[1];
+                }
+
+                const float x       = fmin * expf(kd * (i + 0.5f));
+                if (msc != NULL)
+                {
+                    msc->pvData[0][i]   = x;
+                    msc->pvData[1][i]   = (count > 0) ? lsp_limit(coh / count, 0.0f, 1.0f) : 0.0f;
+                }
+                if (gd != NULL)
+                {
+                    gd->pvData[0][i]    = x;
+                    gd->pvData[1][i]    = ((dr != 0.0f) || (di != 0.0f)) ? kt * atan2f(di, dr) : 0.0f;
+                }
+            }
+
+            if (msc != NULL)
+                msc->data(2, points);
+            if (gd != NULL)
+                gd->data(2, points);
+        }
+
+        void phase_detector::update_telemetry(size_t samples)
+        {
+            // Accept the new file name only when the writer is not active
+            if (sTlmWriter.completed())
+                sTlmWriter.reset();
+
+            plug::path_t *path  = pTlmFile->buffer<plug::path_t>();
+            if ((path != NULL) && (path->pending()) && (sTlmWriter.idle()))
+            {
+                path->accept();
+                strncpy(sTlmPath, path->path(), PATH_MAX - 1);
+                sTlmPath[PATH_MAX - 1]  = '\0';
+                bTlmReopen          = true;
+                path->commit();
+            }
+
+            // Emit the record
+            nTlmPosition       += samples;
+            if ((bTelemetry) && (!bBypass))
+            {
+                nTlmCounter        += samples;
+                if (nTlmCounter >= nTlmInterval)
+                {
+                    nTlmCounter        %= nTlmInterval;
+
+                    const uatomic_t head    = nTlmHead;
+                    const uatomic_t tail    = atomic_load(&nTlmTail);
+                    if ((head - tail) < meta::phase_detector_metadata::TELEMETRY_RECORDS)
+                    {
+                        system::time_t ts;
+                        system::get_time(&ts);
+
+                        telemetry_t *r      = &vTlmRecords[head % meta::phase_detector_metadata::TELEMETRY_RECORDS];
+                        r->nSeconds         = ts.seconds;
+                        r->nNanos           = ts.nanos;
+                        r->nPosition        = nTlmPosition;
+                        r->nBest            = nBest;
+                        r->nSelected        = nSelected;
+                        r->nWorst           = nWorst;
+                        r->fValue           = fBestValue;
+                        r->fConfidence      = fConfidence;
+
+                        atomic_store(&nTlmHead, head + 1);
+                    }
+                    else
+                        ++nTlmDropped;
+                }
+            }
+
+            // Trigger the writer task
+            if ((!sTlmWriter.idle()) || (pWrapper == NULL))
+                return;
+            if ((!bTlmReopen) && (nTlmHead == atomic_load(&nTlmTail)))
+                return;
+
+            ipc::IExecutor *executor = pWrapper->executor();
+            if (executor != NULL)
+                executor->submit(&sTlmWriter);
+        }
+
+        void phase_detector::state_loaded()
+        {
+            // Restore the correlation state on the next processing cycle
+            bWarmLoad           = true;
+        }
+
+        void phase_detector::update_warm_state(size_t samples)
+        {
+            release_warm_state();
+
+            // Do not overwrite the saved state until it has been restored
+            if ((!bWarmStart) || (bBypass) || (bWarmLoad) || (pWrapper == NULL))
+                return;
+
+            nWarmCounter       += samples;
+            if ((nWarmCounter < nWarmInterval) || (!sWarmWriter.idle()))
+                return;
+            nWarmCounter        = 0;
+
+            // Make the snapshot of the computed part of the accumulated function. The function is
+            // stored without decimation, so sharp peaks keep their exact value and position
+            const size_t points = nFuncCount;
+            warm_header_t *hdr  = reinterpret_cast<warm_header_t *>(vWarmState);
+            float *data         = reinterpret_cast<float *>(&vWarmState[sizeof(warm_header_t)]);
+
+            hdr->nMagic         = CPU_TO_LE(WARM_STATE_MAGIC);
+            hdr->nSampleRate    = CPU_TO_LE(uint32_t(fSampleRate));
+            hdr->nVectorSize    = CPU_TO_LE(uint32_t(nVectorSize));
+            hdr->nFuncFirst     = CPU_TO_LE(uint32_t(nFuncFirst));
+            hdr->nFuncCount     = CPU_TO_LE(uint32_t(nFuncCount));
+            hdr->nPoints        = CPU_TO_LE(uint32_t(points));
+            for (size_t i=0; i<points; ++i)
+                data[i]             = CPU_TO_LE(vAccumulated[nFuncFirst + i]);
+            nWarmSize           = sizeof(warm_header_t) + points * sizeof(float);
+            sWarmWriter.bind(vWarmState, nWarmSize);
+
+            ipc::IExecutor *executor = pWrapper->executor();
+            if (executor != NULL)
+                executor->submit(&sWarmWriter);
+        }
+
+        void phase_detector::restore_warm_state()
+        {
+            if (pWrapper == NULL)
+                return;
+            if (!bWarmStart)
+            {
+                bWarmLoad           = false;
+                return;
+            }
+
+            core::KVTStorage *kvt   = pWrapper->kvt_trylock();
+            if (kvt == NULL)
+                return;
+            lsp_finally { pWrapper->kvt_release(); };
+            bWarmLoad           = false;
+
+            const core::kvt_param_t *p = NULL;
+            if (kvt->get(WARM_STATE_KVT, &p, core::KVT_BLOB) != STATUS_OK)
+                return;
+            if ((p->blob.data == NULL) || (p->blob.size < sizeof(warm_header_t)))
+                return;
+
+            // Validate the header
+            warm_header_t hdr;
+            const uint8_t *data = static_cast<const uint8_t *>(p->blob.data);
+            memcpy(&hdr, data, sizeof(warm_header_t));
+            const size_t points = LE_TO_CPU(hdr.nPoints);
+
+            if ((LE_TO_CPU(hdr.nMagic) != WARM_STATE_MAGIC) ||
+                (LE_TO_CPU(hdr.nSampleRate) != uint32_t(fSampleRate)) ||
+                (LE_TO_CPU(hdr.nVectorSize) != uint32_t(nVectorSize)) ||
+                (LE_TO_CPU(hdr.nFuncFirst) != uint32_t(nFuncFirst)) ||
+                (LE_TO_CPU(hdr.nFuncCount) != uint32_t(nFuncCount)) ||
+                (points != nFuncCount) ||
+                (p->blob.size < (sizeof(warm_header_t) + points * sizeof(float))))
+            {
+                lsp_debug("saved correlation state does not match current configuration");
+                return;
+            }
+
+            // Decode the data to the accumulated function
+            float *dst          = &vAccumulated[nFuncFirst];
+            memcpy(dst, &data[sizeof(warm_header_t)], points * sizeof(float));
+            for (size_t i=0; i<points; ++i)
+                dst[i]              = LE_TO_CPU(dst[i]);
+
+            lsp_debug("restored correlation state of %d points", int(points));
+        }
+
+        void phase_detector::request_pool()
+        {
+            // The pool starts threads on the first connection, so connect in background
+            if ((nPoolId >= 0) || (!sPoolConnector.idle()) || (pWrapper == NULL))
+                return;
+
+            ipc::IExecutor *executor = pWrapper->executor();
+            if (executor != NULL)
+                executor->submit(&sPoolConnector);
+        }
+
+        status_t phase_detector::connect_pool()
+        {
+            nPoolPending        = analysis_pool::connect();
+            lsp_trace("analysis pool id = %d", int(nPoolPending));
+            return (nPoolPending >= 0) ? STATUS_OK : STATUS_UNKNOWN_ERR;
+        }
+
+        void phase_detector::release_warm_state()
+        {
+            if (sWarmWriter.completed())
+                sWarmWriter.reset();
+            if ((!sWarmWriter.idle()) || (vWarmRetired == NULL))
+                return;
+
+            delete [] vWarmRetired;
+            vWarmRetired    = NULL;
+        }
+
+        status_t phase_detector::write_warm_state(const uint8_t *data, size_t size)
+        {
+            core::KVTStorage *kvt   = pWrapper->kvt_lock();
+            if (kvt == NULL)
+                return STATUS_OK;
+            lsp_finally { pWrapper->kvt_release(); };
+
+            core::kvt_param_t p;
+            p.type              = core::KVT_BLOB;
+            p.blob.ctype        = WARM_STATE_CTYPE;
+            p.blob.size         = size;
+            p.blob.data         = data;
+
+            return kvt->put(WARM_STATE_KVT, &p, core::KVT_RX);
+        }
+
+        status_t phase_detector::write_telemetry()
+        {
+            status_t res;
+            char buf[0x100];
+
+            // Re-open the file if the path has changed
+            if (bTlmReopen)
+            {
+                bTlmReopen          = false;
+                if (bTlmOpened)
+                {
+                    sTlmFile.close();
+                    bTlmOpened          = false;
+                }
+
+                if (sTlmPath[0] != '\0')
+                {
+                    // Open the file and append data to the end
+                    res = sTlmFile.open(sTlmPath, io::File::FM_WRITE | io::File::FM_CREATE);
+                    if (res != STATUS_OK)
+                    {
+                        lsp_warn("Could not open telemetry file %s, error code=%d", sTlmPath, int(res));
+                        return res;
+                    }
+                    bTlmOpened          = true;
+
+                    if ((res = sTlmFile.seek(0, io::File::FSK_END)) != STATUS_OK)
+                        return res;
+                    if (sTlmFile.position() == 0)
+                    {
+                        const char *header  = "time,position,best,selected,worst,value,confidence\n";
+                        sTlmFile.write(header, strlen(header));
+                    }
+                }
+            }
+
+            // Drain the ring buffer
+            const uatomic_t head    = atomic_load(&nTlmHead);
+            for (uatomic_t tail = nTlmTail; tail != head; )
+            {
+                const telemetry_t *r    = &vTlmRecords[tail % meta::phase_detector_metadata::TELEMETRY_RECORDS];
+                if (bTlmOpened)
+                {
+                    int count = snprintf(buf, sizeof(buf), "%lld.%06d,%llu,%d,%d,%d,%.6f,%.6f\n",
+                        (long long)(r->nSeconds), int(r->nNanos / 1000), (unsigned long long)(r->nPosition),
+                        int(r->nBest), int(r->nSelected), int(r->nWorst),
+                        r->fValue, r->fConfidence);
+                    if ((count > 0) && (size_t(count) < sizeof(buf)))
+                        sTlmFile.write(buf, count);
+                }
+
+                atomic_store(&nTlmTail, ++tail);
+            }
+
+            return STATUS_OK;
         }
 
         bool phase_detector::inline_display(plug::ICanvas *cv, size_t width, size_t height)
@@ -511,7 +2405,7 @@ namespace lsp
                 cv->set_color_rgb(CV_RED);
                 ssize_t point   = ssize_t(nVectorSize) - nWorst;
                 float x         = width - point/di;
-                float y         = cy - dy * vNormalized[point];
+                float y         = cy - dy * fWorstValue;
                 cv->line(x, 0, x, height);
                 cv->line(0, y, width, y);
 
@@ -520,7 +2414,7 @@ namespace lsp
                 cv->set_color_rgb(CV_GREEN);
                 point           = ssize_t(nVectorSize) - nBest;
                 x               = width - point/di;
-                y               = cy - dy * vNormalized[point];
+                y               = cy - dy * fBestValue;
                 cv->line(x, 0, x, height);
                 cv->line(0, y, width, y);
             }
@@ -549,6 +2443,24 @@ namespace lsp
             v->end_object();
         }
 
+        void phase_detector::dump_extremums(dspu::IStateDumper *v, const extremum_t *list, const char *label)
+        {
+            v->begin_array(label, list, meta::phase_detector_metadata::PEAKS_MAX);
+            {
+                for (size_t i=0; i<meta::phase_detector_metadata::PEAKS_MAX; ++i)
+                {
+                    const extremum_t *e = &list[i];
+                    v->begin_object(e, sizeof(extremum_t));
+                    {
+                        v->write("nIndex", e->nIndex);
+                        v->write("fValue", e->fValue);
+                    }
+                    v->end_object();
+                }
+            }
+            v->end_array();
+        }
+
         void phase_detector::dump(dspu::IStateDumper *v) const
         {
             v->write("fTimeInterval", fTimeInterval);
@@ -560,7 +2472,11 @@ namespace lsp
             v->write("nMaxVectorSize", nMaxVectorSize);
             v->write("nVectorSize", nVectorSize);
             v->write("nFuncSize", nFuncSize);
-            v->write("vNormalized", vNormalized);
+            v->write("nFuncFirst", nFuncFirst);
+            v->write("nFuncCount", nFuncCount);
+            v->write("fLagMin", fLagMin);
+            v->write("fLagMax", fLagMax);
+            v->write("nGapSize", nGapSize);
             v->write("nMaxGapSize", nMaxGapSize);
             v->write("nGapOffset", nGapOffset);
 
@@ -570,17 +2486,208 @@ namespace lsp
 
             dump_buffer(v, &vA, "vA");
             dump_buffer(v, &vB, "vB");
+            v->begin_array("vChannels", vChannels, 2);
+            {
+                for (size_t i=0; i<2; ++i)
+                {
+                    const channel_t *c = &vChannels[i];
+                    v->begin_object(c, sizeof(channel_t));
+                    {
+                        v->write_object_array("sLine", c->sLine, 2);
+                        v->writev("fGain", c->fGain, 2);
+                        v->write("vBuffer", c->vBuffer);
+                    }
+                    v->end_object();
+                }
+            }
+            v->end_array();
+
+            v->write("fBestValue", fBestValue);
+            v->write("fSelectedValue", fSelectedValue);
+            v->write("fWorstValue", fWorstValue);
+            v->write("fConfidence", fConfidence);
+            dump_extremums(v, vPeaks, "vPeaks");
+            dump_extremums(v, vDips, "vDips");
+            v->write("nPeaks", nPeaks);
+            v->write("nDips", nDips);
+            v->begin_array("vAccumulators", vAccumulators, meta::phase_detector_metadata::ACCUMULATORS);
+            {
+                for (size_t i=0; i<meta::phase_detector_metadata::ACCUMULATORS; ++i)
+                {
+                    const accumulator_t *acc = &vAccumulators[i];
+                    v->begin_object(acc, sizeof(accumulator_t));
+                    {
+                        v->write("vData", acc->vData);
+                        v->write("fReactivity", acc->fReactivity);
+                        v->write("fTau", acc->fTau);
+                        v->write("fPeriodTau", acc->fPeriodTau);
+                        v->write("fNorm", acc->fNorm);
+                        v->write("nBest", acc->nBest);
+                        v->write("nWorst", acc->nWorst);
+                        v->write("fBestValue", acc->fBestValue);
+                        v->write("fWorstValue", acc->fWorstValue);
+                        v->write("bEnabled", acc->bEnabled);
+
+                        v->write("pEnabled", acc->pEnabled);
+                        v->write("pReactivity", acc->pReactivity);
+                        v->write("pBestTime", acc->pBestTime);
+                        v->write("pBestValue", acc->pBestValue);
+                        v->write("pWorstTime", acc->pWorstTime);
+                        v->write("pWorstValue", acc->pWorstValue);
+                        v->write("pFunction", acc->pFunction);
+                    }
+                    v->end_object();
+                }
+            }
+            v->end_array();
+
+            v->write("nAlign", nAlign);
+            v->write("bAlignInv", bAlignInv);
+            v->write("nAlignReq", nAlignReq);
+            v->write("bAlignReqInv", bAlignReqInv);
+            v->write("nAlignHold", nAlignHold);
+            v->write("nAlignHoldMax", nAlignHoldMax);
+            v->write("nActiveLine", nActiveLine);
+            v->write("nFadePos", nFadePos);
+            v->write("nFadeLen", nFadeLen);
+
+            v->begin_object("sSpectrum", &sSpectrum, sizeof(spectrum_t));
+            {
+                const spectrum_t *sp = &sSpectrum;
+                v->writev("vFrame", sp->vFrame, 2);
+                v->writev("vFft", sp->vFft, 2);
+                v->write("vTemp", sp->vTemp);
+                v->write("vWindow", sp->vWindow);
+                v->write("vCross", sp->vCross);
+                v->writev("vPower", sp->vPower, 2);
+                v->write("nRank", sp->nRank);
+                v->write("nSize", sp->nSize);
+                v->write("nFill", sp->nFill);
+                v->write("fTau", sp->fTau);
+            }
+            v->end_object();
+            v->write("bSpectral", bSpectral);
+
+            v->write("sTlmWriter", &sTlmWriter);
+            v->write("sTlmFile", &sTlmFile);
+            v->write("vTlmRecords", vTlmRecords);
+            v->write("nTlmHead", nTlmHead);
+            v->write("nTlmTail", nTlmTail);
+            v->write("nTlmPosition", nTlmPosition);
+            v->write("nTlmCounter", nTlmCounter);
+            v->write("nTlmInterval", nTlmInterval);
+            v->write("nTlmDropped", nTlmDropped);
+            v->write("bTelemetry", bTelemetry);
+            v->write("bTlmReopen", bTlmReopen);
+            v->write("bTlmOpened", bTlmOpened);
+            v->write("sTlmPath", sTlmPath);
+
+            v->begin_object("sPrewhiten", &sPrewhiten, sizeof(prewhiten_t));
+            {
+                const prewhiten_t *pw = &sPrewhiten;
+                v->writev("vBuffer", pw->vBuffer, 2);
+                v->writev("vOut", pw->vOut, 2);
+                v->writev("vCorr", pw->vCorr, meta::phase_detector_metadata::PREWHITEN_ORDER + 1);
+                v->writev("vCoeffs", pw->vCoeffs, meta::phase_detector_metadata::PREWHITEN_ORDER + 1);
+                v->write("fLogDecay", pw->fLogDecay);
+            }
+            v->end_object();
+            v->write("bPrewhiten", bPrewhiten);
+
+            v->write("sCorrJob", &sCorrJob);
+            v->write("sPoolConnector", &sPoolConnector);
+            v->write("nPoolId", nPoolId);
+            v->write("nPoolPending", nPoolPending);
+            v->write("nJobChunks", nJobChunks);
+            v->begin_array("vChunks", vChunks, nChunks);
+            {
+                for (size_t i=0; i<nChunks; ++i)
+                {
+                    const corr_chunk_t *c = &vChunks[i];
+                    v->begin_object(c, sizeof(corr_chunk_t));
+                    {
+                        v->write("nFirst", c->nFirst);
+                        v->write("nCount", c->nCount);
+                        v->write("nGapOffset", c->nGapOffset);
+                        v->write("nGapSize", c->nGapSize);
+                        v->write("nVectorSize", c->nVectorSize);
+                        v->write("fTau", c->fTau);
+                        v->writev("vTau", c->vTau, meta::phase_detector_metadata::ACCUMULATORS);
+                        v->writev("vEnabled", c->vEnabled, meta::phase_detector_metadata::ACCUMULATORS);
+                        v->write("vFunction", c->vFunction);
+                        v->write("vAccumulated", c->vAccumulated);
+                        v->writev("vAccumulators", c->vAccumulators, meta::phase_detector_metadata::ACCUMULATORS);
+                    }
+                    v->end_object();
+                }
+            }
+            v->end_array();
+            v->write("nChunks", nChunks);
+            v->write("vChunkData", vChunkData);
+            v->write("bMultithread", bMultithread);
+
+            v->begin_object("sMls", &sMls, sizeof(mls_t));
+            {
+                const mls_t *mls = &sMls;
+                v->write("vSignal", mls->vSignal);
+                v->write("vTagS", mls->vTagS);
+                v->write("vTagL", mls->vTagL);
+                v->write("vCapture", mls->vCapture);
+                v->write("vTransform", mls->vTransform);
+                v->write("vExcitation", mls->vExcitation);
+                v->write("nOrder", mls->nOrder);
+                v->write("nLength", mls->nLength);
+                v->write("nPosition", mls->nPosition);
+                v->write("nPeriods", mls->nPeriods);
+                v->write("fTau", mls->fTau);
+                v->write("fLevel", mls->fLevel);
+            }
+            v->end_object();
+            v->write("bActive", bActive);
+            v->write("nActiveFade", nActiveFade);
+
+            v->write("sWarmWriter", &sWarmWriter);
+            v->write("vWarmState", vWarmState);
+            v->write("nWarmSize", nWarmSize);
+            v->write("vWarmRetired", vWarmRetired);
+            v->write("nWarmCounter", nWarmCounter);
+            v->write("nWarmInterval", nWarmInterval);
+            v->write("bWarmStart", bWarmStart);
+            v->write("bWarmLoad", bWarmLoad);
+
+            v->write("fHopTime", fHopTime);
+            v->write("nHopSize", nHopSize);
+            v->write("nHopCounter", nHopCounter);
+            v->write("nEventBest", nEventBest);
+            v->write("bEventValid", bEventValid);
 
             v->write("fTau", fTau);
             v->write("fSelector", fSelector);
             v->write("bBypass", bBypass);
+            v->write("bAlign", bAlign);
+            v->write("bPolarity", bPolarity);
 
             v->writev("vIn", vIn, 2);
             v->writev("vOut", vOut, 2);
+            v->write("pMidiOut", pMidiOut);
             v->write("pBypass", pBypass);
             v->write("pReset", pReset);
             v->write("pSelector", pSelector);
+            v->write("pLagMin", pLagMin);
+            v->write("pLagMax", pLagMax);
             v->write("pReactivity", pReactivity);
+            v->write("pHop", pHop);
+            v->write("pAlign", pAlign);
+            v->write("pPolarity", pPolarity);
+            v->write("pSpectral", pSpectral);
+            v->write("pPrewhiten", pPrewhiten);
+            v->write("pMultithread", pMultithread);
+            v->write("pActive", pActive);
+            v->write("pActiveLevel", pActiveLevel);
+            v->write("pWarmStart", pWarmStart);
+            v->write("pTelemetry", pTelemetry);
+            v->write("pTlmInterval", pTlmInterval);
+            v->write("pTlmFile", pTlmFile);
             v->begin_array("vMeters", vMeters, MK_COUNT);
             {
                 for (size_t i=0; i<MK_COUNT; ++i)
@@ -597,7 +2704,29 @@ namespace lsp
                 }
             }
             v->end_array();
+            v->write("pAlignTime", pAlignTime);
+            v->write("pConfidence", pConfidence);
+            v->write("pNumPeaks", pNumPeaks);
+            v->write("pNumDips", pNumDips);
+            v->begin_array("vExtMeters", vExtMeters, meta::phase_detector_metadata::PEAKS_MAX - 1);
+            {
+                for (size_t i=0; i<meta::phase_detector_metadata::PEAKS_MAX - 1; ++i)
+                {
+                    const extremum_meters_t *em = &vExtMeters[i];
+                    v->begin_object(em, sizeof(extremum_meters_t));
+                    {
+                        v->write("pPeakTime", em->pPeakTime);
+                        v->write("pPeakValue", em->pPeakValue);
+                        v->write("pDipTime", em->pDipTime);
+                        v->write("pDipValue", em->pDipValue);
+                    }
+                    v->end_object();
+                }
+            }
+            v->end_array();
             v->write("pFunction", pFunction);
+            v->write("pCoherence", pCoherence);
+            v->write("pGroupDelay", pGroupDelay);
 
             v->write_object("pIDisplay", pIDisplay);
         }